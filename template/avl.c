@@ -2,15 +2,26 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <limits.h>
 #include "avl.h"
+#include "node_pool.h"
+#include "thread_pool.h"
+
+// Subtrees at least this tall are worth handing to another thread
+#define AVL_PARALLEL_HEIGHT 14
 
 /*
  * This structure represents a single node in a AVL tree.  In addition to containing
  * pointers to its two child nodes (i.e. `left` and `right`), it contains the `key`
  * field representing the data stored at this node.  The `key` field is an
  * integer value that should be used as an identifier for the data in this
- * node.  Nodes in the AVL should be ordered based on this `key` field.
- * It also contains a `height` field that represents the height of the node
+ * node.  Nodes in the AVL should be ordered based on this `key` field.  The
+ * `value` field stores data associated with the key.
+ * It also contains a `height` field that represents the height of the node.
+ * Each node also stands for the interval [key, high]: nodes are ordered by
+ * (key, high), so several intervals may start at the same key, and `max` is
+ * the largest `high` in the node's subtree, which lets overlap queries skip
+ * subtrees that end too early.  A plain key is the interval [key, key].
 
  * You should not modify this structure.
  */
@@ -18,6 +29,9 @@
 struct avl_node
 {
     int key;
+    int high;
+    int max;
+    void* value;
     int height;
     struct avl_node *left;
     struct avl_node *right;
@@ -26,13 +40,19 @@ struct avl_node
 
 /*
  * This structure represents an entire AVL tree.  It specifically contains a
- * reference to the root node of the tree.
- *
- * You should not modify this structure.
+ * reference to the root node of the tree, and the `pool` its nodes are
+ * allocated from.  Trees that exchange nodes (join, split and the set
+ * operations) end up sharing one pool, so they must not be modified from
+ * different threads at the same time.  A tree made by avl_create_wavl() has
+ * `wavl` set and rebalances as a weak AVL tree; `relaxed` is set once a
+ * delete may have left it less balanced than an AVL tree.
  */
 struct avl_tree
 {
     struct avl_node* root;
+    struct node_pool* pool;
+    int wavl;
+    int relaxed;
 };
 
 /*
@@ -43,6 +63,23 @@ struct avl_tree* avl_create() {
     struct avl_tree* avl = malloc(sizeof(struct avl_tree));
     assert(avl);
     avl->root = NULL;
+    avl->pool = node_pool_create(sizeof(struct avl_node));
+    assert(avl->pool);
+    avl->wavl = 0;
+    avl->relaxed = 0;
+    return avl;
+}
+
+/*
+ * This function should allocate and initialize a new, empty tree that
+ * rebalances as a weak AVL (WAVL) tree.  Inserts behave exactly as in an
+ * AVL tree, but a remove does at most two rotations and usually none, where
+ * an AVL tree may rotate at every level.  The height stays below 2 log2(n).
+ * Every other avl function works on it unchanged.
+ */
+struct avl_tree* avl_create_wavl() {
+    struct avl_tree* avl = avl_create();
+    avl->wavl = 1;
     return avl;
 }
 
@@ -50,34 +87,62 @@ struct avl_tree* avl_create() {
  * This function should remove a key/value pair with a specified key from a
  * given BST.  If multiple values with the same key exist in the tree, this
  * function should remove the first one it encounters (i.e. the one closest to
- * the root of the tree).
+ * the root of the tree).  Only the interval [key, key] is removed.
  */
 void avl_remove(struct avl_tree* avl, int key) {
+    avl_remove_interval(avl, key, key);
+}
+
+/*
+ * This function should remove the interval [low, high], if it is in the
+ * tree.
+ */
+void avl_remove_interval(struct avl_tree* avl, int low, int high) {
     assert(avl);
-    avl->root = _avl_subtree_remove(avl->root, key);
+    if (avl->wavl) {
+        _avl_wavl_remove(avl, low, high);
+        return;
+    }
+    avl->root = _avl_subtree_remove(avl->pool, avl->root, low, high);
+    if (avl->root != NULL)
+        avl->root->parent = NULL;
 }
 
 /*
- * This function should insert a new node with key into the AVL tree. 
+ * This function should insert a new node with key and value into the AVL
+ * tree.  Keys are unique: if key is already in the tree, its value is
+ * replaced instead.  The key is stored as the interval [key, key].
  */
-void avl_insert(struct avl_tree* avl, int key) {
+void avl_insert(struct avl_tree* avl, int key, void* value) {
+    avl_insert_interval(avl, key, key, value);
+}
+
+/*
+ * This function should insert the interval [low, high] with a value.  Each
+ * interval is stored once: inserting one that is already in the tree
+ * replaces its value.
+ */
+void avl_insert_interval(struct avl_tree* avl, int low, int high, void* value) {
     assert(avl);
-    avl->root = _avl_subtree_insert(avl->root, key);
+    assert(low <= high);
+    if (avl->wavl) {
+        _avl_wavl_insert(avl, low, high, value);
+        return;
+    }
+    avl->root = _avl_subtree_insert(avl->pool, avl->root, low, high, value);
 }
 
 /*
  * This function should free the memory associated with a AVL tree.  While this
  * function should up all memory used in the AVL tree itself, it should not free
  * any memory allocated to the pointer values stored in the AVL tree.  This is the
- * responsibility of the caller.
+ * responsibility of the caller.  The nodes go with the slabs of the tree's
+ * pool, so this is O(n / slab size) rather than a remove per node.
  *
  */
 void avl_free(struct avl_tree* avl) {
     assert(avl);
-    while (avl->root != NULL) {
-        avl_remove(avl, avl->root->key);
-    }
-
+    node_pool_free(avl->pool);
     free(avl);
 }
 
@@ -95,6 +160,30 @@ int max(int a, int b){
     return (a > b)? a : b;
 }
 
+/* Recomputes the height and max endpoint of N from its children */
+void _avl_node_update(struct avl_node *N){
+    N->height = 1 + max(height(N->left), height(N->right));
+    _avl_node_update_max(N);
+}
+
+/* Recomputes only the max endpoint of N from its children */
+void _avl_node_update_max(struct avl_node *N){
+    N->max = N->high;
+    if (N->left != NULL)
+        N->max = max(N->max, N->left->max);
+    if (N->right != NULL)
+        N->max = max(N->max, N->right->max);
+}
+
+/* Compares the interval [low, high] with node N's, ordering by low first */
+int _avl_cmp(int low, int high, struct avl_node *N){
+    if (low != N->key)
+        return low < N->key ? -1 : 1;
+    if (high != N->high)
+        return high < N->high ? -1 : 1;
+    return 0;
+}
+
 
 /* Get Balance factor of node N */
 int getBalance(struct avl_node *node){
@@ -132,56 +221,68 @@ struct avl_node* _avl_subtree_leftmost_node(struct avl_node* n) {
 
 
 /*
- * Helper function to remove a given key from a subtree of a BST rooted at
- * a specified node.
+ * Helper function to remove a given interval from a subtree of a BST rooted
+ * at a specified node.
  */
-struct avl_node* _avl_subtree_remove(struct avl_node* n, int key) {
+struct avl_node* _avl_subtree_remove(struct node_pool* pool, struct avl_node* n, int key, int high) {
     if (n == NULL) 
         return NULL;
      
-    else if (key < n->key) {
-        n->left = _avl_subtree_remove(n->left, key);
-        return n;
+    else if (_avl_cmp(key, high, n) < 0) {
+        n->left = _avl_subtree_remove(pool, n->left, key, high);
+        if (n->left != NULL)
+            n->left->parent = n;
+        return rebalance(n);
     } 
 
-    else if (key > n->key) {
-        n->right = _avl_subtree_remove(n->right, key);
-        return n;
+    else if (_avl_cmp(key, high, n) > 0) {
+        n->right = _avl_subtree_remove(pool, n->right, key, high);
+        if (n->right != NULL)
+            n->right->parent = n;
+        return rebalance(n);
     }
 
 
     if (n->left != NULL && n->right != NULL) {
         struct avl_node* in_order_succ = _avl_subtree_leftmost_node(n->right);
         n->key = in_order_succ->key;
-        n->right = _avl_subtree_remove(n->right, in_order_succ->key);
-        return n;
+        n->high = in_order_succ->high;
+        n->value = in_order_succ->value;
+        n->right = _avl_subtree_remove(pool, n->right, n->key, n->high);
+        if (n->right != NULL)
+            n->right->parent = n;
+        return rebalance(n);
     } 
 
     else if (n->left != NULL) {
         struct avl_node* left_child = n->left;
-        free(n);
+        node_pool_release(pool, n);
         return left_child;
     } 
     
     else if (n->right != NULL) {
         struct avl_node* right_child = n->right;
-        free(n);
+        node_pool_release(pool, n);
         return right_child;
     } 
 
     else {
-        free(n);
+        node_pool_release(pool, n);
         return NULL;
     }
 }
 
 
  
-/* Helper function that allocates a new node with the given key and
-    NULL left and right pointers. */
-struct avl_node* _avl_node_create(int key){
-    struct avl_node* node = malloc(sizeof(struct avl_node));
+/* Helper function that allocates a new node from the pool with the given
+    interval and value and NULL left and right pointers. */
+struct avl_node* _avl_node_create(struct node_pool* pool, int key, int high, void* value){
+    struct avl_node* node = node_pool_alloc(pool);
+    assert(node);
     node->key = key;
+    node->high = high;
+    node->max = high;
+    node->value = value;
     node->left = NULL;
     node->right = NULL;
     node->parent = NULL;
@@ -190,43 +291,25 @@ struct avl_node* _avl_node_create(int key){
 }
 
 
+/* Restores the height of N and, if it is out of balance by 2, rotates it back
+ * into balance.  Returns the new root of the subtree. */
 struct avl_node *rebalance(struct avl_node *N){
+    _avl_node_update(N);
+
     if (getBalance(N) < -1){
         if (getBalance(N->left) > 0){
             N->left = leftRotate(N->left);
         }
-        struct avl_node* newSubtreeRoot = rightRotate(N);
-        if (newSubtreeRoot->parent != NULL){
-            if (newSubtreeRoot->parent != NULL){
-                if (newSubtreeRoot->parent->left == N){
-                    newSubtreeRoot->parent->left = newSubtreeRoot;
-                }
-                else{
-                    newSubtreeRoot->parent->right = newSubtreeRoot;
-                }
-            }
-        }
+        return rightRotate(N);
     }
     else if (getBalance(N) > 1){
         if (getBalance(N->right) < 0){
             N->right = rightRotate(N->right);
         }
-        struct avl_node* newSubtreeRoot = leftRotate(N);
-        if (newSubtreeRoot->parent != NULL){
-            if (newSubtreeRoot->parent != NULL){
-                if (newSubtreeRoot->parent == N){
-                    newSubtreeRoot->parent->left = newSubtreeRoot;
-                }
-                else{
-                    newSubtreeRoot->parent->right = newSubtreeRoot;
-                }
-            }
-        }
+        return leftRotate(N);
     }
-    else{
-        N->height = 1 + max(height(N->left), height(N->right));
-    }
-    
+
+    return N;
 }
 
 /*****************************************************
@@ -258,10 +341,10 @@ struct avl_node *rightRotate(struct avl_node *N){
     // Set N's parent to be child
     N->parent = child;
 
-    // Update height of N and child
-    N->height = 1 + max(height(N->left), height(N->right));
+    // Update height and max endpoint of N, then of child above it
+    _avl_node_update(N);
 
-    child->height = 1 + max(height(child->left), height(child->right));
+    _avl_node_update(child);
 
     // Return pointer to child
     return child;
@@ -289,9 +372,9 @@ struct avl_node *leftRotate(struct avl_node *N){
 
     N->parent = child;
 
-    N->height = 1 + max(height(N->left), height(N->right));
+    _avl_node_update(N);
 
-    child->height = 1 + max(height(child->left), height(child->right));
+    _avl_node_update(child);
     
     return child;
     
@@ -302,26 +385,27 @@ struct avl_node *leftRotate(struct avl_node *N){
 /* Recursive function to insert a key in the subtree rooted
  * with node and returns the new root of the subtree.
  */
-struct avl_node* _avl_subtree_insert(struct avl_node* node, int key){
+struct avl_node* _avl_subtree_insert(struct node_pool* pool, struct avl_node* node, int key, int high, void* value){
     /* normal BST insertion */
     /* Note: you may also want to modify the provided insertion function */
 
     // Base case that node is null and creates a new node with key
     if (node == NULL)
-        return _avl_node_create(key);
+        return _avl_node_create(pool, key, high, value);
     
     // Recursively insert in left subtree
-    if (key < node->key){
-    	node->left = _avl_subtree_insert(node->left, key);
+    if (_avl_cmp(key, high, node) < 0){
+    	node->left = _avl_subtree_insert(pool, node->left, key, high, value);
         node->left->parent = node;
     }
     // Recursively insert in right subtree
-    else if (key > node->key){
-        node->right = _avl_subtree_insert(node->right, key);
+    else if (_avl_cmp(key, high, node) > 0){
+        node->right = _avl_subtree_insert(pool, node->right, key, high, value);
     	node->right->parent = node;
     }
-    // Return pointer to current node
+    // Key already present, the new value replaces the old one
     else{
+        node->value = value;
         return node;
     }
 
@@ -330,30 +414,30 @@ struct avl_node* _avl_subtree_insert(struct avl_node* node, int key){
      *        to maintain a height-balanced tree
      */
 
-    // Update height
-    node->height = 1 + max(height(node->left), height(node->right));
+    // Update height and max endpoint
+    _avl_node_update(node);
 
     // Get balance
     int balance = getBalance(node);
 
     // LL, if balance factor is < -1 and key is less than key of left child, perform right rotation on current node
-    if (balance < -1 && key < node->left->key){
+    if (balance < -1 && _avl_cmp(key, high, node->left) < 0){
         return rightRotate(node);
     }
 
     // RR, if balance factor is > 1 and key is greater than right child's key, perform left rotate
-    if (balance > 1 && key > node->right->key){
+    if (balance > 1 && _avl_cmp(key, high, node->right) > 0){
         return leftRotate(node);
     }
 
     // LR, left rotation on left child, and then right rotation on current node
-    if (balance < -1 && key > node->left->key){
+    if (balance < -1 && _avl_cmp(key, high, node->left) > 0){
         node->left = leftRotate(node->left);
         return rightRotate(node);
     }
 
     // RL, right rotation on right child, and then left rotation on current node
-    if (balance > 1 && key < node->right->key){
+    if (balance > 1 && _avl_cmp(key, high, node->right) < 0){
         node->right = rightRotate(node->right);
         return leftRotate(node);
     }
@@ -362,3 +446,847 @@ struct avl_node* _avl_subtree_insert(struct avl_node* node, int key){
     return node;    
 }
 
+
+/*****************************************************
+ *  Join-based bulk operations
+ *****************************************************/
+
+/* Makes mid the parent of left and right.  Their heights must differ by at
+ * most one. */
+struct avl_node* _avl_node_attach(struct avl_node* left, struct avl_node* mid, struct avl_node* right){
+    mid->left = left;
+    mid->right = right;
+    if (left != NULL)
+        left->parent = mid;
+    if (right != NULL)
+        right->parent = mid;
+    _avl_node_update(mid);
+    return mid;
+}
+
+/* Returns a tree of every key in left, then mid, then every key in right, in
+ * O(|rank(left) - rank(right)|).  All keys in left must be less than mid's
+ * and all keys in right greater.  The join works on ranks, so it takes AVL
+ * trees (rank = height) and relaxed WAVL trees alike: walk down the spine of
+ * the taller tree to the first subtree c of rank at most rank(shorter) + 1,
+ * hang mid there with c and the shorter tree below it, and if mid ends up
+ * with its parent's rank, fix that the way an insert does.  AVL inputs give
+ * an AVL result. */
+struct avl_node* _avl_node_join(struct avl_node* left, struct avl_node* mid, struct avl_node* right){
+    // The roots may still point at parents they were split from
+    if (left != NULL)
+        left->parent = NULL;
+    if (right != NULL)
+        right->parent = NULL;
+
+    int left_taller = height(left) > height(right) + 1;
+    if (!left_taller && height(right) <= height(left) + 1){
+        mid->parent = NULL;
+        return _avl_node_attach(left, mid, right);
+    }
+
+    struct avl_tree sub = { left_taller ? left : right, NULL, 1, 0 };
+    struct avl_node* p = NULL;
+    struct avl_node* c = sub.root;
+    int stop = height(left_taller ? right : left) + 1;
+
+    while (height(c) > stop){
+        p = c;
+        c = left_taller ? c->right : c->left;
+    }
+
+    if (left_taller){
+        _avl_node_attach(c, mid, right);
+        p->right = mid;
+    }
+    else{
+        _avl_node_attach(left, mid, c);
+        p->left = mid;
+    }
+    mid->parent = p;
+
+    _avl_wavl_update_path(p);
+    _avl_wavl_insert_fixup(&sub, mid);
+    return sub.root;
+}
+
+/* Splits the subtree at node into the intervals ordered before [key, high]
+ * (*left) and after it (*right) in O(log n).  Returns the detached node
+ * holding [key, high], or NULL if there is none. */
+struct avl_node* _avl_node_split(struct avl_node* node, int key, int high, struct avl_node** left, struct avl_node** right){
+    if (node == NULL){
+        *left = NULL;
+        *right = NULL;
+        return NULL;
+    }
+
+    struct avl_node* l = node->left;
+    struct avl_node* r = node->right;
+    struct avl_node* found;
+
+    if (_avl_cmp(key, high, node) == 0){
+        *left = l;
+        *right = r;
+        node->left = NULL;
+        node->right = NULL;
+        _avl_node_update(node);
+        return node;
+    }
+
+    // Split the side key falls in, then join the other side back on
+    if (_avl_cmp(key, high, node) < 0){
+        struct avl_node* rest;
+        found = _avl_node_split(l, key, high, left, &rest);
+        *right = _avl_node_join(rest, node, r);
+    }
+    else{
+        struct avl_node* rest;
+        found = _avl_node_split(r, key, high, &rest, right);
+        *left = _avl_node_join(l, node, rest);
+    }
+
+    return found;
+}
+
+/* Detaches the node with the largest key from the subtree at node, storing
+ * what is left in *rest. */
+struct avl_node* _avl_node_split_last(struct avl_node* node, struct avl_node** rest){
+    if (node->right == NULL){
+        *rest = node->left;
+        return node;
+    }
+
+    struct avl_node* right;
+    struct avl_node* last = _avl_node_split_last(node->right, &right);
+    *rest = _avl_node_join(node->left, node, right);
+    return last;
+}
+
+/* Join without a middle key: every key in left must be less than every key
+ * in right. */
+struct avl_node* _avl_node_join2(struct avl_node* left, struct avl_node* right){
+    if (left == NULL)
+        return right;
+
+    struct avl_node* rest;
+    struct avl_node* last = _avl_node_split_last(left, &rest);
+    return _avl_node_join(rest, last, right);
+}
+
+/* Nodes a set operation drops, linked through `left`.  Each job of a
+ * parallel operation keeps its own list, so no lock is needed, and the
+ * lists are handed back to the pool once the operation is done. */
+struct avl_garbage{
+    struct avl_node* head;
+    struct avl_node* tail;
+};
+
+/* Adds one node to a garbage list. */
+void _avl_garbage_push(struct avl_garbage* g, struct avl_node* n){
+    n->left = g->head;
+    g->head = n;
+    if (g->tail == NULL)
+        g->tail = n;
+}
+
+/* Moves every node of `from` onto `g` in O(1). */
+void _avl_garbage_splice(struct avl_garbage* g, struct avl_garbage* from){
+    if (from->head == NULL)
+        return;
+    from->tail->left = g->head;
+    g->head = from->head;
+    if (g->tail == NULL)
+        g->tail = from->tail;
+}
+
+/* Gives every node on a garbage list back to the pool. */
+void _avl_garbage_release(struct node_pool* pool, struct avl_garbage* g){
+    while (g->head != NULL){
+        struct avl_node* next = g->head->left;
+        node_pool_release(pool, g->head);
+        g->head = next;
+    }
+    g->tail = NULL;
+}
+
+/* Adds every node below n to a garbage list, iteratively. */
+void _avl_subtree_discard(struct avl_node* n, struct avl_garbage* g){
+    // Rotate left children up so the tree becomes a right-going list
+    while (n != NULL){
+        if (n->left == NULL){
+            struct avl_node* next = n->right;
+            _avl_garbage_push(g, n);
+            n = next;
+        }
+        else{
+            struct avl_node* left = n->left;
+            n->left = left->right;
+            left->right = n;
+            n = left;
+        }
+    }
+}
+
+#define AVL_UNION 0
+#define AVL_INTERSECT 1
+#define AVL_DIFFERENCE 2
+
+struct avl_node* _avl_node_set_op(int op, struct avl_node* a, struct avl_node* b, struct thread_pool* pool, struct avl_garbage* g);
+
+/* One half of a set operation, as run by the thread pool. */
+struct avl_set_job{
+    int op;
+    struct avl_node* a;
+    struct avl_node* b;
+    struct thread_pool* pool;
+    struct avl_node* result;
+    struct avl_garbage garbage;
+};
+
+void _avl_set_job_run(void* arg){
+    struct avl_set_job* job = arg;
+    job->result = _avl_node_set_op(job->op, job->a, job->b, job->pool, &job->garbage);
+}
+
+/* Runs op on (a1, b1) and (a2, b2), the first on the pool when it is big
+ * enough to pay for a task. */
+void _avl_set_op_fork(int op, struct thread_pool* pool, struct avl_garbage* g, struct avl_node* a1, struct avl_node* b1, struct avl_node** out1, struct avl_node* a2, struct avl_node* b2, struct avl_node** out2){
+    struct avl_set_job job = { op, a1, b1, pool, NULL, { NULL, NULL } };
+    struct thread_pool_task* task = NULL;
+
+    if (pool != NULL && max(height(a1), height(b1)) >= AVL_PARALLEL_HEIGHT)
+        task = thread_pool_spawn(pool, _avl_set_job_run, &job);
+
+    if (task == NULL)
+        _avl_set_job_run(&job);
+
+    *out2 = _avl_node_set_op(op, a2, b2, pool, g);
+
+    if (task != NULL)
+        thread_pool_wait(pool, task);
+    *out1 = job.result;
+    _avl_garbage_splice(g, &job.garbage);
+}
+
+/* Union, intersection or difference of the subtrees at a and b, reusing
+ * their nodes and putting the ones not kept on g.  The root of one tree splits
+ * the other, the two halves are handled independently (in parallel when a
+ * pool is given) and joined back together: O(m log(n/m + 1)) work for sizes
+ * m <= n. */
+struct avl_node* _avl_node_set_op(int op, struct avl_node* a, struct avl_node* b, struct thread_pool* pool, struct avl_garbage* g){
+    struct avl_node *l, *r, *left, *right, *found;
+
+    if (op == AVL_UNION){
+        if (a == NULL)
+            return b;
+        if (b == NULL)
+            return a;
+
+        // Keys in both trees keep a's node
+        found = _avl_node_split(b, a->key, a->high, &l, &r);
+        if (found != NULL)
+            _avl_garbage_push(g, found);
+        _avl_set_op_fork(op, pool, g, a->left, l, &left, a->right, r, &right);
+        return _avl_node_join(left, a, right);
+    }
+
+    if (op == AVL_INTERSECT){
+        if (a == NULL || b == NULL){
+            _avl_subtree_discard(a, g);
+            _avl_subtree_discard(b, g);
+            return NULL;
+        }
+
+        found = _avl_node_split(b, a->key, a->high, &l, &r);
+        _avl_set_op_fork(op, pool, g, a->left, l, &left, a->right, r, &right);
+
+        // a's root stays only if b had it too
+        if (found != NULL){
+            _avl_garbage_push(g, found);
+            return _avl_node_join(left, a, right);
+        }
+        _avl_garbage_push(g, a);
+        return _avl_node_join2(left, right);
+    }
+
+    // AVL_DIFFERENCE, split a by b's root instead
+    if (a == NULL || b == NULL){
+        _avl_subtree_discard(b, g);
+        return a;
+    }
+
+    found = _avl_node_split(a, b->key, b->high, &l, &r);
+    if (found != NULL)
+        _avl_garbage_push(g, found);
+    struct avl_node* b_left = b->left;
+    struct avl_node* b_right = b->right;
+    _avl_garbage_push(g, b);
+    _avl_set_op_fork(op, pool, g, l, b_left, &left, r, b_right, &right);
+    return _avl_node_join2(left, right);
+}
+
+/* Moves every node of other into avl under op and leaves other empty. */
+void _avl_tree_set_op(int op, struct avl_tree* avl, struct avl_tree* other, struct thread_pool* pool){
+    assert(avl);
+    assert(other);
+
+    // Kept nodes of both trees now live in one pool
+    node_pool_merge(avl->pool, other->pool);
+    avl->relaxed |= other->relaxed;
+    other->relaxed = 0;
+
+    struct avl_garbage g = { NULL, NULL };
+    avl->root = _avl_node_set_op(op, avl->root, other->root, pool, &g);
+    if (avl->root != NULL)
+        avl->root->parent = NULL;
+    other->root = NULL;
+    _avl_tree_normalize(avl);
+
+    // Dropped nodes are reused by later inserts
+    _avl_garbage_release(avl->pool, &g);
+}
+
+/*
+ * This function should append every key of `other` to `avl` in O(log n) and
+ * leave `other` empty.  Every key in `other` must be greater than every key
+ * in `avl`.
+ */
+void avl_join(struct avl_tree* avl, struct avl_tree* other) {
+    assert(avl);
+    assert(other);
+    node_pool_merge(avl->pool, other->pool);
+    avl->relaxed |= other->relaxed;
+    other->relaxed = 0;
+    avl->root = _avl_node_join2(avl->root, other->root);
+    if (avl->root != NULL)
+        avl->root->parent = NULL;
+    other->root = NULL;
+    _avl_tree_normalize(avl);
+}
+
+/*
+ * This function should move every key of `avl` that is greater than or
+ * equal to `key` into `right`, which must be empty, in O(log n).  Intervals
+ * go by their low end.
+ */
+void avl_split(struct avl_tree* avl, int key, struct avl_tree* right) {
+    assert(avl);
+    assert(right);
+    assert(right->root == NULL);
+    node_pool_merge(avl->pool, right->pool);
+    right->relaxed = avl->relaxed;
+
+    struct avl_node *l, *r;
+    struct avl_node* found = _avl_node_split(avl->root, key, INT_MIN, &l, &r);
+
+    // key itself goes right, as the smallest key there
+    if (found != NULL)
+        r = _avl_node_join(NULL, found, r);
+
+    avl->root = l;
+    right->root = r;
+    if (l != NULL)
+        l->parent = NULL;
+    if (r != NULL)
+        r->parent = NULL;
+    _avl_tree_normalize(right);
+}
+
+/* Sorts n packed (key, index) pairs by their upper 32 bits with an LSD radix
+ * sort, one byte per pass, using tmp (n entries) as scratch.  Stable, so
+ * equal keys stay in index order.  Passes where every entry has the same
+ * byte are skipped.  Returns whichever of the two buffers ends up sorted. */
+unsigned long long* _avl_radix_sort(unsigned long long* a, unsigned long long* tmp, int n){
+    for (int shift = 32; shift < 64 && n > 0; shift += 8){
+        int count[257] = { 0 };
+        for (int i = 0; i < n; i++)
+            count[((a[i] >> shift) & 0xff) + 1]++;
+        if (count[((a[0] >> shift) & 0xff) + 1] == n)
+            continue;
+
+        for (int b = 0; b < 256; b++)
+            count[b + 1] += count[b];
+        for (int i = 0; i < n; i++)
+            tmp[count[(a[i] >> shift) & 0xff]++] = a[i];
+
+        unsigned long long* t = a;
+        a = tmp;
+        tmp = t;
+    }
+    return a;
+}
+
+/* Builds a perfectly balanced subtree from nodes[lo, hi), which are in key
+ * order, in O(hi - lo).  The median of every range is its root, so sibling
+ * heights differ by at most one. */
+struct avl_node* _avl_node_build(struct avl_node** nodes, int lo, int hi){
+    if (lo >= hi)
+        return NULL;
+    int mid = lo + (hi - lo) / 2;
+    struct avl_node* left = _avl_node_build(nodes, lo, mid);
+    struct avl_node* right = _avl_node_build(nodes, mid + 1, hi);
+    return _avl_node_attach(left, nodes[mid], right);
+}
+
+/*
+ * This function should insert n keys, in any order, with their values (or
+ * NULL for every key if values is NULL).  Like n calls to avl_insert(), a
+ * key already in the tree gets its new value, and within the batch the last
+ * value given for a key wins.
+ *
+ * Instead of n walks from the root, the batch is radix sorted, built into a
+ * balanced tree in O(n) and unioned into the tree by split and join, which
+ * costs O(n log(size / n + 1)) and only touches the parts of the tree the
+ * batch falls in.
+ */
+void avl_insert_batch(struct avl_tree* avl, int* keys, void** values, int n) {
+    assert(avl);
+    if (n <= 0)
+        return;
+
+    unsigned long long* buf = malloc(2 * (size_t)n * sizeof(unsigned long long));
+    assert(buf);
+
+    // Bias keys so unsigned order is signed order, index below for stability
+    for (int i = 0; i < n; i++)
+        buf[i] = (unsigned long long)((unsigned)keys[i] ^ 0x80000000u) << 32 | (unsigned)i;
+    unsigned long long* sorted = _avl_radix_sort(buf, buf + n, n);
+
+    // One node per distinct key, carrying its last value
+    struct avl_node** nodes = malloc((size_t)n * sizeof(struct avl_node*));
+    assert(nodes);
+    int m = 0;
+    for (int i = 0; i < n; i++){
+        int at = (int)(sorted[i] & 0xffffffffu);
+        if (i + 1 < n && sorted[i + 1] >> 32 == sorted[i] >> 32)
+            continue;
+        nodes[m++] = _avl_node_create(avl->pool, keys[at], keys[at], values != NULL ? values[at] : NULL);
+    }
+    free(buf);
+
+    struct avl_node* batch = _avl_node_build(nodes, 0, m);
+    free(nodes);
+
+    // The batch goes first so its values win over the tree's
+    struct avl_garbage g = { NULL, NULL };
+    avl->root = _avl_node_set_op(AVL_UNION, batch, avl->root, NULL, &g);
+    avl->root->parent = NULL;
+
+    _avl_garbage_release(avl->pool, &g);
+}
+
+/*
+ * This function should make `avl` the union of `avl` and `other`, reusing
+ * the nodes of both and leaving `other` empty.  For a key in both trees,
+ * the value from `avl` is kept.  With a pool, independent
+ * halves run on its threads; pool may be NULL to run on the caller only.
+ */
+void avl_union(struct avl_tree* avl, struct avl_tree* other, struct thread_pool* pool) {
+    _avl_tree_set_op(AVL_UNION, avl, other, pool);
+}
+
+/*
+ * This function should keep only the keys of `avl` that are also in
+ * `other`, freeing the rest and leaving `other` empty.  pool may be NULL.
+ */
+void avl_intersect(struct avl_tree* avl, struct avl_tree* other, struct thread_pool* pool) {
+    _avl_tree_set_op(AVL_INTERSECT, avl, other, pool);
+}
+
+/*
+ * This function should remove from `avl` every key that is in `other`,
+ * freeing `other`'s nodes and leaving it empty.  pool may be NULL.
+ */
+void avl_difference(struct avl_tree* avl, struct avl_tree* other, struct thread_pool* pool) {
+    _avl_tree_set_op(AVL_DIFFERENCE, avl, other, pool);
+}
+
+
+/*****************************************************
+ *  Lookup and in-order iteration
+ *****************************************************/
+
+/* Returns the node holding [key, high], or NULL. */
+struct avl_node* _avl_subtree_find(struct avl_node* n, int key, int high){
+    while (n != NULL && _avl_cmp(key, high, n) != 0)
+        n = _avl_cmp(key, high, n) < 0 ? n->left : n->right;
+    return n;
+}
+
+/* Returns the first node with key >= key (> key if strict), or NULL. */
+struct avl_node* _avl_subtree_bound(struct avl_node* n, int key, int strict){
+    struct avl_node* best = NULL;
+    while (n != NULL){
+        if (n->key > key || (!strict && n->key == key)){
+            best = n;
+            n = n->left;
+        }
+        else{
+            n = n->right;
+        }
+    }
+    return best;
+}
+
+/* Returns the in-order successor of n, or NULL, by climbing parent pointers
+ * when n has no right subtree. */
+struct avl_node* _avl_node_successor(struct avl_node* n){
+    if (n->right != NULL)
+        return _avl_subtree_leftmost_node(n->right);
+    while (n->parent != NULL && n->parent->right == n)
+        n = n->parent;
+    return n->parent;
+}
+
+/*
+ * This function should return the value stored with key, or NULL if the key
+ * is not in the tree.  O(log n).
+ */
+void* avl_get(struct avl_tree* avl, int key) {
+    assert(avl);
+    struct avl_node* n = _avl_subtree_find(avl->root, key, key);
+    return n != NULL ? n->value : NULL;
+}
+
+/*
+ * This function should return 1 if key is in the tree and 0 otherwise, which
+ * also tells a stored NULL value apart from a missing key.
+ */
+int avl_contains(struct avl_tree* avl, int key) {
+    assert(avl);
+    return _avl_subtree_find(avl->root, key, key) != NULL;
+}
+
+/*
+ * This function should find the smallest key in the tree that is greater
+ * than or equal to key.  Returns 1 and stores it in *out if there is one,
+ * 0 otherwise.
+ */
+int avl_lower_bound(struct avl_tree* avl, int key, int* out) {
+    assert(avl);
+    struct avl_node* n = _avl_subtree_bound(avl->root, key, 0);
+    if (n == NULL)
+        return 0;
+    *out = n->key;
+    return 1;
+}
+
+/*
+ * This function should find the smallest key in the tree that is strictly
+ * greater than key.  Returns 1 and stores it in *out if there is one, 0
+ * otherwise.
+ */
+int avl_upper_bound(struct avl_tree* avl, int key, int* out) {
+    assert(avl);
+    struct avl_node* n = _avl_subtree_bound(avl->root, key, 1);
+    if (n == NULL)
+        return 0;
+    *out = n->key;
+    return 1;
+}
+
+/*
+ * This function should position an iterator, usually on the caller's stack,
+ * at the smallest key of the tree.  Iterators allocate nothing and need no
+ * free: each step follows child and parent pointers, O(1) amortized.  The
+ * tree must not be modified while it is being iterated.
+ */
+void avl_iterator_init(struct avl_iterator* iter, struct avl_tree* avl) {
+    assert(iter);
+    assert(avl);
+    iter->next = avl->root != NULL ? _avl_subtree_leftmost_node(avl->root) : NULL;
+}
+
+/*
+ * This function should position an iterator at the smallest key greater
+ * than or equal to key, in O(log n).
+ */
+void avl_iterator_seek(struct avl_iterator* iter, struct avl_tree* avl, int key) {
+    assert(iter);
+    assert(avl);
+    iter->next = _avl_subtree_bound(avl->root, key, 0);
+}
+
+/*
+ * This function should return 1 if the iterator has keys left and 0 if it
+ * has reached the end of the tree.
+ */
+int avl_iterator_has_next(struct avl_iterator* iter) {
+    assert(iter);
+    return iter->next != NULL;
+}
+
+/*
+ * This function should return the next key in order and store its value in
+ * *value (if value is not NULL), then advance the iterator.  Only call it
+ * when avl_iterator_has_next() returns 1.
+ */
+int avl_iterator_next(struct avl_iterator* iter, void** value) {
+    assert(iter);
+    assert(iter->next);
+    struct avl_node* n = iter->next;
+    if (value != NULL)
+        *value = n->value;
+    iter->next = _avl_node_successor(n);
+    return n->key;
+}
+
+
+/*****************************************************
+ *  Interval queries
+ *****************************************************/
+
+/* Reports every interval below n that overlaps [low, high] and returns how
+ * many there were.  A subtree is skipped when its max endpoint is below low,
+ * and everything right of a node starting after high is skipped too. */
+int _avl_subtree_overlap(struct avl_node* n, int low, int high, void (*visit)(int low, int high, void* value, void* arg), void* arg){
+    int count = 0;
+
+    while (n != NULL && n->max >= low){
+        count += _avl_subtree_overlap(n->left, low, high, visit, arg);
+
+        if (n->key > high)
+            break;
+        if (n->high >= low){
+            if (visit != NULL)
+                visit(n->key, n->high, n->value, arg);
+            count++;
+        }
+
+        // Continue right without another stack frame
+        n = n->right;
+    }
+
+    return count;
+}
+
+/*
+ * This function should call visit(low, high, value, arg) for every interval
+ * in the tree that overlaps [low, high] (endpoints included), in order, and
+ * return how many there were.  visit may be NULL to only count them.
+ *
+ * Every subtree the search enters holds an overlap, except along the two
+ * paths bounding the query, so it costs O(log n + k log(n / k)) for k
+ * results: O(log n) when there are none, and never worse than O((k + 1)
+ * log n).
+ */
+int avl_overlap_query(struct avl_tree* avl, int low, int high, void (*visit)(int low, int high, void* value, void* arg), void* arg) {
+    assert(avl);
+    if (low > high)
+        return 0;
+    return _avl_subtree_overlap(avl->root, low, high, visit, arg);
+}
+
+/*
+ * This function should call visit for every interval containing point and
+ * return how many there were.  See avl_overlap_query().
+ */
+int avl_stab(struct avl_tree* avl, int point, void (*visit)(int low, int high, void* value, void* arg), void* arg) {
+    return avl_overlap_query(avl, point, point, visit, arg);
+}
+
+
+/*****************************************************
+ *  Weak AVL (WAVL) rebalancing
+ *****************************************************/
+
+/* In a WAVL tree `height` holds a rank rather than the height.  A missing
+ * child has rank -1, every leaf has rank 0, and every rank difference (a
+ * node's rank minus its child's) is 1 or 2.  An AVL tree is a WAVL tree with
+ * rank = height, and inserts keep it that way, but deletes only demote ranks
+ * and may leave rank > height; such a tree is `relaxed`.  Join works on ranks,
+ * so the join-based operations take relaxed trees as they are. */
+
+/* Points whatever pointed at old, its parent or the root, at new. */
+void _avl_wavl_replace(struct avl_tree* avl, struct avl_node* parent, struct avl_node* old, struct avl_node* new){
+    if (parent == NULL)
+        avl->root = new;
+    else if (parent->left == old)
+        parent->left = new;
+    else
+        parent->right = new;
+}
+
+/* Rotates child up over its parent.  Both keep their ranks, for the caller
+ * to promote or demote; max endpoints are updated. */
+void _avl_wavl_rotate_up(struct avl_tree* avl, struct avl_node* child){
+    struct avl_node* p = child->parent;
+    struct avl_node* g = p->parent;
+    int rank_p = p->height;
+    int rank_child = child->height;
+
+    struct avl_node* top = p->left == child ? rightRotate(p) : leftRotate(p);
+    _avl_wavl_replace(avl, g, p, top);
+
+    p->height = rank_p;
+    child->height = rank_child;
+}
+
+/* Recomputes max endpoints from n up to the root. */
+void _avl_wavl_update_path(struct avl_node* n){
+    for (; n != NULL; n = n->parent)
+        _avl_node_update_max(n);
+}
+
+/* Restores the rank rule after x may have become a 0-child (the same rank as
+ * its parent), with x a leaf or a 1,2 node.  Promotions move the violation up
+ * until a node's sibling side is a 2-child, where one single or double
+ * rotation ends it.  Max endpoints must already be correct; rotations keep
+ * them so. */
+void _avl_wavl_insert_fixup(struct avl_tree* avl, struct avl_node* x){
+    struct avl_node* p = x->parent;
+
+    while (p != NULL && p->height == x->height){
+        struct avl_node* s = p->left == x ? p->right : p->left;
+
+        // 0,1 node: promote it, the violation may move up
+        if (p->height - height(s) == 1){
+            p->height++;
+            x = p;
+            p = p->parent;
+            continue;
+        }
+
+        // 0,2 node: rotate x up, or x's inner child if it is a 1-child
+        struct avl_node* y = p->left == x ? x->right : x->left;
+        if (y == NULL || x->height - y->height == 2){
+            _avl_wavl_rotate_up(avl, x);
+            p->height--;
+        }
+        else{
+            _avl_wavl_rotate_up(avl, y);
+            _avl_wavl_rotate_up(avl, y);
+            y->height++;
+            x->height--;
+            p->height--;
+        }
+        break;
+    }
+}
+
+/* Inserts [key, high] bottom-up as a new leaf, then restores the rank rule. */
+void _avl_wavl_insert(struct avl_tree* avl, int key, int high, void* value){
+    struct avl_node* p = NULL;
+    struct avl_node** link = &avl->root;
+
+    while (*link != NULL){
+        int c = _avl_cmp(key, high, *link);
+        if (c == 0){
+            (*link)->value = value;
+            return;
+        }
+        p = *link;
+        link = c < 0 ? &p->left : &p->right;
+    }
+
+    struct avl_node* added = _avl_node_create(avl->pool, key, high, value);
+    added->parent = p;
+    *link = added;
+
+    _avl_wavl_update_path(p);
+    _avl_wavl_insert_fixup(avl, added);
+}
+
+/* Removes [key, high].  The removed node's parent may become a 2,2 leaf or
+ * get a 3-child; demotions move that up until a rotation (single or double)
+ * ends it, so a delete never rotates more than twice. */
+void _avl_wavl_remove(struct avl_tree* avl, int key, int high){
+    struct avl_node* y = _avl_subtree_find(avl->root, key, high);
+    if (y == NULL)
+        return;
+
+    // Two children, take the successor's interval and remove it instead
+    if (y->left != NULL && y->right != NULL){
+        struct avl_node* succ = _avl_subtree_leftmost_node(y->right);
+        y->key = succ->key;
+        y->high = succ->high;
+        y->value = succ->value;
+        y = succ;
+    }
+
+    struct avl_node* x = y->left != NULL ? y->left : y->right;
+    struct avl_node* p = y->parent;
+    int x_left = p != NULL && p->left == y;
+
+    _avl_wavl_replace(avl, p, y, x);
+    if (x != NULL)
+        x->parent = p;
+    node_pool_release(avl->pool, y);
+    avl->relaxed = 1;
+
+    struct avl_node* fix = p;
+
+    // A leaf must have rank 0
+    if (p != NULL && p->left == NULL && p->right == NULL && p->height == 1){
+        p->height = 0;
+        x = p;
+        p = p->parent;
+        x_left = p != NULL && p->left == x;
+    }
+
+    while (p != NULL && p->height - height(x) == 3){
+        struct avl_node* s = x_left ? p->right : p->left;
+
+        // Sibling is a 2-child: demote p and move up
+        if (p->height - s->height == 2){
+            p->height--;
+        }
+        // Sibling is a 2,2 node: demote both and move up
+        else if (s->height - height(s->left) == 2 && s->height - height(s->right) == 2){
+            p->height--;
+            s->height--;
+        }
+        else{
+            struct avl_node* outer = x_left ? s->right : s->left;
+            struct avl_node* inner = x_left ? s->left : s->right;
+
+            if (s->height - height(outer) == 1){
+                _avl_wavl_rotate_up(avl, s);
+                s->height++;
+                p->height--;
+                if (p->left == NULL && p->right == NULL)
+                    p->height--;
+            }
+            else{
+                _avl_wavl_rotate_up(avl, inner);
+                _avl_wavl_rotate_up(avl, inner);
+                inner->height += 2;
+                s->height--;
+                p->height -= 2;
+            }
+            break;
+        }
+
+        x = p;
+        p = p->parent;
+        x_left = p != NULL && p->left == x;
+    }
+
+    _avl_wavl_update_path(fix);
+}
+
+/* Rebuilds an AVL tree that a join, split or set operation filled with nodes
+ * of a relaxed WAVL tree into a perfectly balanced one in O(n), so that its
+ * ranks are heights again, which AVL rebalancing relies on.  Does nothing to
+ * other trees; WAVL trees stay relaxed. */
+void _avl_tree_normalize(struct avl_tree* avl){
+    if (!avl->relaxed || avl->wavl)
+        return;
+    avl->relaxed = 0;
+    if (avl->root == NULL)
+        return;
+
+    int n = 0;
+    for (struct avl_node* c = _avl_subtree_leftmost_node(avl->root); c != NULL; c = _avl_node_successor(c))
+        n++;
+
+    struct avl_node** nodes = malloc((size_t)n * sizeof(struct avl_node*));
+    assert(nodes);
+    n = 0;
+    for (struct avl_node* c = _avl_subtree_leftmost_node(avl->root); c != NULL; c = _avl_node_successor(c))
+        nodes[n++] = c;
+
+    avl->root = _avl_node_build(nodes, 0, n);
+    avl->root->parent = NULL;
+    free(nodes);
+}
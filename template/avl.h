@@ -11,6 +11,17 @@
 
 struct avl_node;
 struct avl_tree;
+struct node_pool;
+struct thread_pool;
+
+/*
+ * In-order iterator.  It holds only the next node, so it can live on the
+ * stack and needs no free.
+ */
+struct avl_iterator
+{
+    struct avl_node* next;
+};
 
 
 /* 
@@ -24,17 +35,55 @@ void _preOrder_helper (struct avl_node* node);
 void preOrder(struct avl_tree *avl);
 
 struct avl_tree* avl_create();
+struct avl_tree* avl_create_wavl();
 void avl_free(struct avl_tree* avl);
-void avl_insert(struct avl_tree* avl, int key);
+void avl_insert(struct avl_tree* avl, int key, void* value);
 void avl_remove(struct avl_tree* avl, int key);
+void avl_insert_interval(struct avl_tree* avl, int low, int high, void* value);
+void avl_remove_interval(struct avl_tree* avl, int low, int high);
+void avl_insert_batch(struct avl_tree* avl, int* keys, void** values, int n);
+
+// ordered map lookups, O(log n)
+void* avl_get(struct avl_tree* avl, int key);
+int avl_contains(struct avl_tree* avl, int key);
+int avl_lower_bound(struct avl_tree* avl, int key, int* out);
+int avl_upper_bound(struct avl_tree* avl, int key, int* out);
+
+// interval queries, closed intervals; visit may be NULL to only count
+int avl_overlap_query(struct avl_tree* avl, int low, int high, void (*visit)(int low, int high, void* value, void* arg), void* arg);
+int avl_stab(struct avl_tree* avl, int point, void (*visit)(int low, int high, void* value, void* arg), void* arg);
+
+// in-order iteration in key order, without allocating
+void avl_iterator_init(struct avl_iterator* iter, struct avl_tree* avl);
+void avl_iterator_seek(struct avl_iterator* iter, struct avl_tree* avl, int key);
+int avl_iterator_has_next(struct avl_iterator* iter);
+int avl_iterator_next(struct avl_iterator* iter, void** value);
+
+// join-based bulk operations; they take all nodes from `other` (or move them
+// to `right`), and pool may be NULL to run on the calling thread only
+void avl_join(struct avl_tree* avl, struct avl_tree* other);
+void avl_split(struct avl_tree* avl, int key, struct avl_tree* right);
+void avl_union(struct avl_tree* avl, struct avl_tree* other, struct thread_pool* pool);
+void avl_intersect(struct avl_tree* avl, struct avl_tree* other, struct thread_pool* pool);
+void avl_difference(struct avl_tree* avl, struct avl_tree* other, struct thread_pool* pool);
 
 struct avl_node* _avl_subtree_leftmost_node(struct avl_node* n);
-struct avl_node* _avl_subtree_remove(struct avl_node* n, int key);
-struct avl_node* _avl_node_create(int key);
+struct avl_node* _avl_subtree_remove(struct node_pool* pool, struct avl_node* n, int key, int high);
+struct avl_node* _avl_node_create(struct node_pool* pool, int key, int high, void* value);
+struct avl_node* rebalance(struct avl_node *N);
+void _avl_node_update(struct avl_node *N);
+void _avl_node_update_max(struct avl_node *N);
+
+// weak AVL mode, used by avl_insert_interval/avl_remove_interval when set
+void _avl_wavl_insert(struct avl_tree* avl, int key, int high, void* value);
+void _avl_wavl_remove(struct avl_tree* avl, int key, int high);
+void _avl_wavl_insert_fixup(struct avl_tree* avl, struct avl_node* x);
+void _avl_wavl_update_path(struct avl_node* n);
+void _avl_tree_normalize(struct avl_tree* avl);
 
 // three function that you will be modified in this recitation
 struct avl_node* rightRotate(struct avl_node *y);
 struct avl_node* leftRotate(struct avl_node *x);
-struct avl_node* _avl_subtree_insert(struct avl_node* node, int key);
+struct avl_node* _avl_subtree_insert(struct node_pool* pool, struct avl_node* node, int key, int high, void* value);
 
 #endif
@@ -0,0 +1,478 @@
+/***********************************************************************
+** Program Filename: avl_rcu
+** Date: 10/19/2026
+** Description: Implementation for an AVL tree that many threads can read
+while one thread at a time updates it. Lookups take no lock and write no
+shared memory: they load the root once and walk down. Writers never change a
+node readers can reach; they copy the nodes on the path to the change (and
+any sibling a rotation moves), link the copies to the untouched subtrees, and
+publish the new root with a single atomic store. The nodes that were replaced
+are freed through epoch-based reclamation once every reader that could have
+loaded them has finished.
+** Input: None
+** Output: None
+*********************************************************************/
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "epoch.h"
+#include "avl_rcu.h"
+
+// Reader slots in the epoch domain, more concurrent readers spin briefly
+#define AVL_RCU_READERS 128
+
+// Most nodes one update can copy: the path, plus two per level for the
+// rotations of a remove, for any tree that fits in memory
+#define AVL_RCU_MAX_COPIES 192
+
+/*
+ * This structure represents a single node.  Once a node is reachable from
+ * the published root it is never modified again.  `height` is 0 for a leaf,
+ * as in avl.c.
+ */
+struct avl_rcu_node{
+    int key;
+    int height;
+    void* value;
+    struct avl_rcu_node* left;
+    struct avl_rcu_node* right;
+};
+
+/*
+ * This structure represents a tree that can be read and written from many
+ * threads.  `root` is the only field readers look at.
+ */
+struct avl_rcu{
+    _Atomic(struct avl_rcu_node*) root;
+    _Atomic int size;
+    pthread_mutex_t write_lock;
+    struct epoch* epoch;
+};
+
+/*
+ * This structure collects the work of one update: the nodes it allocated,
+ * which are private until the new root is published, and the published
+ * nodes they replace, which are retired after it.
+ */
+struct avl_rcu_op{
+    struct avl_rcu_node* fresh[AVL_RCU_MAX_COPIES];
+    int n_fresh;
+    struct avl_rcu_node* stale[AVL_RCU_MAX_COPIES];
+    int n_stale;
+    int failed;
+};
+
+// Function to return the height of a subtree, -1 if empty
+int avl_rcu_height(struct avl_rcu_node* node){
+    return node ? node->height : -1;
+}
+
+// Function to recompute a private node's height from its children
+void avl_rcu_update(struct avl_rcu_node* node){
+    int l = avl_rcu_height(node->left);
+    int r = avl_rcu_height(node->right);
+    node->height = 1 + (l > r ? l : r);
+}
+
+// Function to allocate a private node.  Sets op->failed and returns NULL if
+// memory or the copy budget ran out
+struct avl_rcu_node* avl_rcu_node_make(struct avl_rcu_op* op, int key, void* value, struct avl_rcu_node* left, struct avl_rcu_node* right){
+
+    if (op->failed || op->n_fresh == AVL_RCU_MAX_COPIES){
+        op->failed = 1;
+        return NULL;
+    }
+
+    struct avl_rcu_node* node = malloc(sizeof(struct avl_rcu_node));
+    if (node == NULL){
+        op->failed = 1;
+        return NULL;
+    }
+
+    node->key = key;
+    node->value = value;
+    node->left = left;
+    node->right = right;
+    avl_rcu_update(node);
+
+    op->fresh[op->n_fresh++] = node;
+
+    return node;
+}
+
+// Function to mark a published node as replaced by this update
+void avl_rcu_drop(struct avl_rcu_op* op, struct avl_rcu_node* node){
+    if (op->n_stale == AVL_RCU_MAX_COPIES){
+        op->failed = 1;
+        return;
+    }
+    op->stale[op->n_stale++] = node;
+}
+
+// Function to return a node this update may modify: the node itself if the
+// update made it, otherwise a private copy that replaces it
+struct avl_rcu_node* avl_rcu_writable(struct avl_rcu_op* op, struct avl_rcu_node* node){
+
+    for (int i = op->n_fresh - 1; i >= 0; i--){
+        if (op->fresh[i] == node){
+            return node;
+        }
+    }
+
+    struct avl_rcu_node* copy = avl_rcu_node_make(op, node->key, node->value, node->left, node->right);
+    if (copy != NULL){
+        avl_rcu_drop(op, node);
+    }
+
+    return copy;
+}
+
+// Function to rotate a private node right, copying its left child
+struct avl_rcu_node* avl_rcu_rotate_right(struct avl_rcu_op* op, struct avl_rcu_node* node){
+
+    struct avl_rcu_node* child = avl_rcu_writable(op, node->left);
+    if (child == NULL){
+        return node;
+    }
+
+    node->left = child->right;
+    child->right = node;
+    avl_rcu_update(node);
+    avl_rcu_update(child);
+
+    return child;
+}
+
+// Function to rotate a private node left, copying its right child
+struct avl_rcu_node* avl_rcu_rotate_left(struct avl_rcu_op* op, struct avl_rcu_node* node){
+
+    struct avl_rcu_node* child = avl_rcu_writable(op, node->right);
+    if (child == NULL){
+        return node;
+    }
+
+    node->right = child->left;
+    child->left = node;
+    avl_rcu_update(node);
+    avl_rcu_update(child);
+
+    return child;
+}
+
+// Function to restore the AVL balance of a private node whose children
+// changed, returning the new subtree root, as rebalance() in avl.c
+struct avl_rcu_node* avl_rcu_rebalance(struct avl_rcu_op* op, struct avl_rcu_node* node){
+
+    avl_rcu_update(node);
+    int balance = avl_rcu_height(node->right) - avl_rcu_height(node->left);
+
+    if (balance < -1){
+        struct avl_rcu_node* left = node->left;
+        if (avl_rcu_height(left->right) > avl_rcu_height(left->left)){
+            left = avl_rcu_writable(op, left);
+            if (left == NULL){
+                return node;
+            }
+            node->left = avl_rcu_rotate_left(op, left);
+        }
+        return avl_rcu_rotate_right(op, node);
+    }
+
+    if (balance > 1){
+        struct avl_rcu_node* right = node->right;
+        if (avl_rcu_height(right->left) > avl_rcu_height(right->right)){
+            right = avl_rcu_writable(op, right);
+            if (right == NULL){
+                return node;
+            }
+            node->right = avl_rcu_rotate_right(op, right);
+        }
+        return avl_rcu_rotate_left(op, node);
+    }
+
+    return node;
+}
+
+// Function to insert below `node`, returning the new subtree root.  Sets
+// *added if the key was not there before
+struct avl_rcu_node* avl_rcu_insert_node(struct avl_rcu_op* op, struct avl_rcu_node* node, int key, void* value, int* added){
+
+    if (node == NULL){
+        *added = 1;
+        return avl_rcu_node_make(op, key, value, NULL, NULL);
+    }
+
+    struct avl_rcu_node* copy = avl_rcu_writable(op, node);
+    if (copy == NULL){
+        return NULL;
+    }
+
+    // Same key, only the value changes
+    if (key == node->key){
+        copy->value = value;
+        return copy;
+    }
+
+    if (key < node->key){
+        copy->left = avl_rcu_insert_node(op, node->left, key, value, added);
+    }
+    else{
+        copy->right = avl_rcu_insert_node(op, node->right, key, value, added);
+    }
+
+    if (op->failed){
+        return copy;
+    }
+
+    return avl_rcu_rebalance(op, copy);
+}
+
+// Function to remove `key`, which must be below `node`, returning the new
+// subtree root
+struct avl_rcu_node* avl_rcu_remove_node(struct avl_rcu_op* op, struct avl_rcu_node* node, int key){
+
+    // At most one child, it takes the node's place unchanged
+    if (key == node->key && (node->left == NULL || node->right == NULL)){
+        avl_rcu_drop(op, node);
+        return node->left != NULL ? node->left : node->right;
+    }
+
+    struct avl_rcu_node* copy = avl_rcu_writable(op, node);
+    if (copy == NULL){
+        return NULL;
+    }
+
+    if (key == node->key){
+        // Two children, the copy takes the in-order successor's pair
+        struct avl_rcu_node* succ = node->right;
+        while (succ->left != NULL){
+            succ = succ->left;
+        }
+        copy->key = succ->key;
+        copy->value = succ->value;
+        copy->right = avl_rcu_remove_node(op, node->right, succ->key);
+    }
+    else if (key < node->key){
+        copy->left = avl_rcu_remove_node(op, node->left, key);
+    }
+    else{
+        copy->right = avl_rcu_remove_node(op, node->right, key);
+    }
+
+    if (op->failed){
+        return copy;
+    }
+
+    return avl_rcu_rebalance(op, copy);
+}
+
+// Function to finish an update, write lock held: publish the new root and
+// retire what it replaced, or throw the private copies away on failure
+void avl_rcu_finish(struct avl_rcu* avl, struct avl_rcu_op* op, struct avl_rcu_node* root){
+
+    if (op->failed){
+        for (int i = 0; i < op->n_fresh; i++){
+            free(op->fresh[i]);
+        }
+        return;
+    }
+
+    // Everything written to the copies is visible before the root is.  The
+    // store is seq_cst, like the loads in the readers and the epoch slots:
+    // release/acquire alone would let epoch_retire() see a reader's slot
+    // empty while that reader still loads the old root
+    atomic_store(&avl->root, root);
+
+    for (int i = 0; i < op->n_stale; i++){
+        epoch_retire(avl->epoch, op->stale[i], free);
+    }
+}
+
+// Function to find the node with `key`, NULL if absent
+struct avl_rcu_node* avl_rcu_find(struct avl_rcu_node* node, int key){
+    while (node != NULL && node->key != key){
+        node = key < node->key ? node->left : node->right;
+    }
+    return node;
+}
+
+// Function to free a subtree, nobody else may be reading it
+void avl_rcu_free_node(struct avl_rcu_node* node){
+    while (node != NULL){
+        struct avl_rcu_node* right = node->right;
+        avl_rcu_free_node(node->left);
+        free(node);
+        node = right;
+    }
+}
+
+/*
+ * This function should allocate and initialize a new, empty concurrent AVL
+ * tree and return a pointer to it.
+ */
+struct avl_rcu* avl_rcu_create(){
+
+    struct avl_rcu* avl = malloc(sizeof(struct avl_rcu));
+    if (avl == NULL){
+        return NULL;
+    }
+
+    avl->epoch = epoch_create(AVL_RCU_READERS);
+    if (avl->epoch == NULL){
+        free(avl);
+        return NULL;
+    }
+
+    atomic_init(&avl->root, NULL);
+    atomic_init(&avl->size, 0);
+    pthread_mutex_init(&avl->write_lock, NULL);
+
+    return avl;
+}
+
+/*
+ * This function should free a concurrent AVL tree and every node in it.  No
+ * other thread may be using the tree.  It does not free the values stored
+ * in it.
+ *
+ * Params:
+ *   avl - the tree to be destroyed.  May be NULL.
+ */
+void avl_rcu_free(struct avl_rcu* avl){
+
+    if (avl == NULL){
+        return;
+    }
+
+    avl_rcu_free_node(atomic_load(&avl->root));
+
+    // No readers are left, so everything retired can go
+    epoch_free(avl->epoch);
+    pthread_mutex_destroy(&avl->write_lock);
+    free(avl);
+}
+
+/*
+ * This function should insert a key/value pair, or give an existing key the
+ * new value.  The nodes on the path are copied and rebalanced privately and
+ * the new root is published atomically, so readers see the tree either
+ * before or after the insert, never halfway.  Writers run one at a time.
+ * If memory runs out the tree is left as it was.
+ *
+ * Params:
+ *   avl - the tree to insert into.  May not be NULL.
+ *   key - the key to insert.
+ *   value - the value to store with it.
+ */
+void avl_rcu_insert(struct avl_rcu* avl, int key, void* value){
+
+    pthread_mutex_lock(&avl->write_lock);
+
+    struct avl_rcu_op op = { .n_fresh = 0, .n_stale = 0, .failed = 0 };
+    int added = 0;
+    struct avl_rcu_node* root = avl_rcu_insert_node(&op, atomic_load(&avl->root), key, value, &added);
+
+    avl_rcu_finish(avl, &op, root);
+    if (!op.failed && added){
+        atomic_fetch_add(&avl->size, 1);
+    }
+
+    pthread_mutex_unlock(&avl->write_lock);
+}
+
+/*
+ * This function should remove `key` from the tree, if it is there, by
+ * publishing a copy of the changed path without it.
+ *
+ * Params:
+ *   avl - the tree to remove from.  May not be NULL.
+ *   key - the key to remove.
+ */
+void avl_rcu_remove(struct avl_rcu* avl, int key){
+
+    pthread_mutex_lock(&avl->write_lock);
+
+    struct avl_rcu_node* cur = atomic_load(&avl->root);
+
+    // Nothing to copy if the key is not there
+    if (avl_rcu_find(cur, key) != NULL){
+        struct avl_rcu_op op = { .n_fresh = 0, .n_stale = 0, .failed = 0 };
+        struct avl_rcu_node* root = avl_rcu_remove_node(&op, cur, key);
+
+        avl_rcu_finish(avl, &op, root);
+        if (!op.failed){
+            atomic_fetch_sub(&avl->size, 1);
+        }
+    }
+
+    pthread_mutex_unlock(&avl->write_lock);
+}
+
+/*
+ * This function should return the value associated with `key`, or NULL if
+ * the key is not there.  It takes no lock and only writes the calling
+ * thread's own epoch slot, so any number of readers run side by side and
+ * alongside a writer.
+ */
+void* avl_rcu_get(struct avl_rcu* avl, int key){
+
+    int slot = epoch_enter(avl->epoch);
+
+    struct avl_rcu_node* node = avl_rcu_find(atomic_load(&avl->root), key);
+    void* value = node ? node->value : NULL;
+
+    epoch_exit(avl->epoch, slot);
+
+    return value;
+}
+
+/*
+ * This function should return 1 if `key` is in the tree and 0 otherwise,
+ * without locking.
+ */
+int avl_rcu_contains(struct avl_rcu* avl, int key){
+
+    int slot = epoch_enter(avl->epoch);
+    int found = avl_rcu_find(atomic_load(&avl->root), key) != NULL;
+    epoch_exit(avl->epoch, slot);
+
+    return found;
+}
+
+/*
+ * This function should find the smallest key greater than or equal to
+ * `key`, without locking.  Returns 1 and stores it in *out if there is one,
+ * 0 otherwise.
+ */
+int avl_rcu_lower_bound(struct avl_rcu* avl, int key, int* out){
+
+    int slot = epoch_enter(avl->epoch);
+
+    struct avl_rcu_node* node = atomic_load(&avl->root);
+    struct avl_rcu_node* best = NULL;
+    while (node != NULL){
+        if (node->key >= key){
+            best = node;
+            node = node->left;
+        }
+        else{
+            node = node->right;
+        }
+    }
+    if (best != NULL){
+        *out = best->key;
+    }
+
+    epoch_exit(avl->epoch, slot);
+
+    return best != NULL;
+}
+
+/*
+ * This function should return the number of keys in the tree.
+ */
+int avl_rcu_size(struct avl_rcu* avl){
+    return atomic_load(&avl->size);
+}
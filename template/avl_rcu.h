@@ -0,0 +1,93 @@
+/*
+ * This file contains the definition of the interface for the concurrent AVL
+ * tree with lock-free lookups.  You can find descriptions of the tree
+ * functions, including their parameters and their return values, in
+ * avl_rcu.c.
+ */
+
+#ifndef __AVL_RCU_H
+#define __AVL_RCU_H
+
+/*
+ * Structure used to represent an AVL tree shared between threads.
+ */
+struct avl_rcu;
+
+/*
+ * Concurrent AVL interface function prototypes.  Refer to avl_rcu.c for
+ * documentation about each of these functions.
+ */
+
+/*********************************************************************
+** Function: avl_rcu_create
+** Description: Allocate and initialize a new, empty concurrent AVL tree
+** Parameters: none
+** Pre-Conditions: none
+** Post-Conditions: Returns pointer to tree, or NULL if allocation fails
+*********************************************************************/
+struct avl_rcu* avl_rcu_create();
+
+/*********************************************************************
+** Function: avl_rcu_free
+** Description: Frees every node of the tree and the tree itself
+** Parameters: struct avl_rcu* avl
+** Pre-Conditions: No other thread uses the tree
+** Post-Conditions: Tree is freed, stored values are not
+*********************************************************************/
+void avl_rcu_free(struct avl_rcu* avl);
+
+/*********************************************************************
+** Function: avl_rcu_insert
+** Description: Publishes a copy of the tree with a key/value pair added
+** Parameters: struct avl_rcu* avl, int key, void* value
+** Pre-Conditions: Pointer to tree; writers are serialized internally
+** Post-Conditions: An existing key gets the new value; tree unchanged if allocation fails
+*********************************************************************/
+void avl_rcu_insert(struct avl_rcu* avl, int key, void* value);
+
+/*********************************************************************
+** Function: avl_rcu_remove
+** Description: Publishes a copy of the tree without a key
+** Parameters: struct avl_rcu* avl, int key
+** Pre-Conditions: Pointer to tree; writers are serialized internally
+** Post-Conditions: Replaced nodes are freed once no reader can see them
+*********************************************************************/
+void avl_rcu_remove(struct avl_rcu* avl, int key);
+
+/*********************************************************************
+** Function: avl_rcu_get
+** Description: Returns the value for a key without locking
+** Parameters: struct avl_rcu* avl, int key
+** Pre-Conditions: Pointer to tree
+** Post-Conditions: Returns value, NULL if the key is absent
+*********************************************************************/
+void* avl_rcu_get(struct avl_rcu* avl, int key);
+
+/*********************************************************************
+** Function: avl_rcu_contains
+** Description: Returns whether a key is in the tree, without locking
+** Parameters: struct avl_rcu* avl, int key
+** Pre-Conditions: Pointer to tree
+** Post-Conditions: Returns 1 if present, 0 otherwise
+*********************************************************************/
+int avl_rcu_contains(struct avl_rcu* avl, int key);
+
+/*********************************************************************
+** Function: avl_rcu_lower_bound
+** Description: Finds the smallest key >= a given key, without locking
+** Parameters: struct avl_rcu* avl, int key, int* out
+** Pre-Conditions: Pointer to tree, out is not NULL
+** Post-Conditions: Returns 1 and stores the key in *out, 0 if there is none
+*********************************************************************/
+int avl_rcu_lower_bound(struct avl_rcu* avl, int key, int* out);
+
+/*********************************************************************
+** Function: avl_rcu_size
+** Description: Returns the number of keys in the tree
+** Parameters: struct avl_rcu* avl
+** Pre-Conditions: Pointer to tree
+** Post-Conditions: Returns size
+*********************************************************************/
+int avl_rcu_size(struct avl_rcu* avl);
+
+#endif
@@ -0,0 +1,194 @@
+/***********************************************************************
+** Program Filename: avl_rcu_bench
+** Date: 10/19/2026
+** Description: Measures how lookups scale with the number of reader threads,
+for the concurrent AVL tree (avl_rcu_get, no lock) and for the plain AVL tree
+behind a reader/writer lock (avl_get under pthread_rwlock_rdlock). For each
+thread count, the readers look up random keys for a fixed time while one
+writer replaces a key every millisecond, and the total lookup rate of both
+trees is printed side by side.
+** Input: avl_rcu_bench [max threads] [keys] [milliseconds per run], by
+default 32 threads, 100000 keys and 500 ms; thread counts double from 1
+** Output: One line per thread count with lookups per second for each tree
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "avl.h"
+#include "avl_rcu.h"
+
+// Time between two updates of the writer, in nanoseconds
+#define WRITER_PAUSE 1000000
+
+/*
+ * Everything one run shares: the tree under test, the lock for the plain
+ * tree, and the flag that stops the threads.
+ */
+struct bench{
+	struct avl_rcu* rcu; // NULL when the plain tree is measured
+	struct avl_tree* avl;
+	pthread_rwlock_t lock;
+	int n_keys;
+	atomic_int stop;
+};
+
+/*
+ * One reader's counter, padded to its own cache line so the counting does
+ * not bounce lines between readers.
+ */
+struct reader{
+	struct bench* bench;
+	unsigned seed;
+	long long lookups;
+	long long found; // Stored so the compiler keeps the lookups
+	char pad[64];
+};
+
+// Function to return a monotonic time in seconds
+double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Function to look up random keys until the run stops
+void* reader_run(void* arg){
+	struct reader* r = arg;
+	struct bench* b = r->bench;
+	long long lookups = 0;
+	long long found = 0;
+	unsigned x = r->seed;
+
+	while (!atomic_load_explicit(&b->stop, memory_order_relaxed)){
+		// Check the flag only every 256 lookups
+		for (int i = 0; i < 256; i++){
+			x = x * 1664525u + 1013904223u;
+			int key = (int)(x % (unsigned)b->n_keys);
+
+			if (b->rcu != NULL){
+				found += avl_rcu_get(b->rcu, key) != NULL;
+			}
+			else{
+				pthread_rwlock_rdlock(&b->lock);
+				found += avl_get(b->avl, key) != NULL;
+				pthread_rwlock_unlock(&b->lock);
+			}
+		}
+		lookups += 256;
+	}
+
+	r->lookups = lookups;
+	r->found = found;
+	return NULL;
+}
+
+// Function to replace a random key every WRITER_PAUSE ns until the run stops
+void* writer_run(void* arg){
+	struct bench* b = arg;
+	struct timespec pause = { 0, WRITER_PAUSE };
+	unsigned x = 12345;
+
+	while (!atomic_load(&b->stop)){
+		x = x * 1664525u + 1013904223u;
+		int key = (int)(x % (unsigned)b->n_keys);
+		void* value = (void*)(size_t)(x | 1);
+
+		if (b->rcu != NULL){
+			avl_rcu_insert(b->rcu, key, value);
+		}
+		else{
+			pthread_rwlock_wrlock(&b->lock);
+			avl_insert(b->avl, key, value);
+			pthread_rwlock_unlock(&b->lock);
+		}
+		nanosleep(&pause, NULL);
+	}
+
+	return NULL;
+}
+
+// Function to run n_threads readers and the writer for ms milliseconds and
+// return the lookups per second
+double bench_run(struct bench* b, int n_threads, int ms){
+	struct reader* readers = calloc(n_threads, sizeof(struct reader));
+	pthread_t* threads = malloc(n_threads * sizeof(pthread_t));
+	pthread_t writer;
+
+	atomic_store(&b->stop, 0);
+	double start = now();
+
+	for (int i = 0; i < n_threads; i++){
+		readers[i].bench = b;
+		readers[i].seed = 2654435761u * (i + 1);
+		pthread_create(&threads[i], NULL, reader_run, &readers[i]);
+	}
+	pthread_create(&writer, NULL, writer_run, b);
+
+	struct timespec run = { ms / 1000, (ms % 1000) * 1000000L };
+	nanosleep(&run, NULL);
+	atomic_store(&b->stop, 1);
+
+	long long total = 0;
+	for (int i = 0; i < n_threads; i++){
+		pthread_join(threads[i], NULL);
+		total += readers[i].lookups;
+	}
+	pthread_join(writer, NULL);
+	double elapsed = now() - start;
+
+	free(readers);
+	free(threads);
+
+	return total / elapsed;
+}
+
+int main(int argc, char const *argv[]) {
+
+	int max_threads = argc > 1 ? atoi(argv[1]) : 32;
+	int n_keys = argc > 2 ? atoi(argv[2]) : 100000;
+	int ms = argc > 3 ? atoi(argv[3]) : 500;
+
+	if (max_threads < 1 || n_keys < 1 || ms < 1){
+		fprintf(stderr, "Usage: %s [max threads] [keys] [milliseconds per run]\n", argv[0]);
+		return 1;
+	}
+
+	// Both trees hold every even key, so half the lookups miss
+	struct avl_rcu* rcu = avl_rcu_create();
+	struct avl_tree* avl = avl_create();
+	if (rcu == NULL){
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	for (int k = 0; k < n_keys; k += 2){
+		avl_rcu_insert(rcu, k, (void*)(size_t)(k + 1));
+		avl_insert(avl, k, (void*)(size_t)(k + 1));
+	}
+
+	struct bench b;
+	b.avl = avl;
+	b.n_keys = n_keys;
+	pthread_rwlock_init(&b.lock, NULL);
+
+	printf("%d keys, one writer every %d us, %d ms per run\n", n_keys / 2 + n_keys % 2, WRITER_PAUSE / 1000, ms);
+	printf("%8s %16s %16s %8s\n", "readers", "avl_rcu/s", "rwlock avl/s", "ratio");
+
+	for (int n = 1; n <= max_threads; n *= 2){
+		b.rcu = rcu;
+		double rcu_rate = bench_run(&b, n, ms);
+		b.rcu = NULL;
+		double lock_rate = bench_run(&b, n, ms);
+
+		printf("%8d %16.0f %16.0f %8.2f\n", n, rcu_rate, lock_rate, rcu_rate / lock_rate);
+	}
+
+	pthread_rwlock_destroy(&b.lock);
+	avl_rcu_free(rcu);
+	avl_free(avl);
+
+	return 0;
+}
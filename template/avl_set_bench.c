@@ -0,0 +1,170 @@
+/***********************************************************************
+** Program Filename: avl_set_bench
+** Date: 10/19/2026
+** Description: Times avl_union, avl_intersect and avl_difference of a large
+tree with a smaller one, across size ratios and thread counts, next to the
+old way of merging: walking the smaller tree and calling avl_insert (or
+avl_remove) for each of its keys. Keys are random, so the trees overlap
+partly and the small tree's keys are spread over the whole large tree.
+** Input: avl_set_bench [keys in the large tree] [max threads], by default
+1000000 keys and 8 threads; thread counts double from 1, where 1 runs with
+no pool at all
+** Output: One line per size ratio and thread count with milliseconds per
+operation
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "avl.h"
+#include "thread_pool.h"
+
+#define AVL_SET_UNION 0
+#define AVL_SET_INTERSECT 1
+#define AVL_SET_DIFFERENCE 2
+
+// Runs averaged for every timing
+#define REPEAT 3
+
+// Function to return a monotonic time in seconds
+double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Function to fill an array with n random keys in [0, range)
+void random_keys(int* keys, int n, int range, unsigned* state){
+	for (int i = 0; i < n; i++){
+		unsigned x = *state;
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		*state = x;
+		keys[i] = (int)(x % (unsigned)range);
+	}
+}
+
+// Function to build a tree of the given keys
+struct avl_tree* build_tree(int* keys, int n){
+	struct avl_tree* avl = avl_create();
+	avl_insert_batch(avl, keys, NULL, n);
+	return avl;
+}
+
+// Function to return the milliseconds one set operation takes, on fresh
+// trees every time since the operation uses them up
+double time_set_op(int op, int* big, int n, int* small, int m, struct thread_pool* pool){
+	double total = 0;
+
+	for (int r = 0; r < REPEAT; r++){
+		struct avl_tree* a = build_tree(big, n);
+		struct avl_tree* b = build_tree(small, m);
+
+		double t = now();
+		if (op == AVL_SET_UNION){
+			avl_union(a, b, pool);
+		}
+		else if (op == AVL_SET_INTERSECT){
+			avl_intersect(a, b, pool);
+		}
+		else{
+			avl_difference(a, b, pool);
+		}
+		total += now() - t;
+
+		avl_free(a);
+		avl_free(b);
+	}
+
+	return total * 1000 / REPEAT;
+}
+
+// Function to return the milliseconds of a union or difference done one key
+// at a time, the way merges were written before the set operations
+double time_one_by_one(int op, int* big, int n, int* small, int m){
+	double total = 0;
+
+	for (int r = 0; r < REPEAT; r++){
+		struct avl_tree* a = build_tree(big, n);
+		struct avl_tree* b = build_tree(small, m);
+
+		double t = now();
+		struct avl_iterator iter;
+		avl_iterator_init(&iter, b);
+		while (avl_iterator_has_next(&iter)){
+			int key = avl_iterator_next(&iter, NULL);
+			if (op == AVL_SET_UNION){
+				avl_insert(a, key, NULL);
+			}
+			else{
+				avl_remove(a, key);
+			}
+		}
+		total += now() - t;
+
+		avl_free(a);
+		avl_free(b);
+	}
+
+	return total * 1000 / REPEAT;
+}
+
+int main(int argc, char const *argv[]) {
+
+	int n = argc > 1 ? atoi(argv[1]) : 1000000;
+	int max_threads = argc > 2 ? atoi(argv[2]) : 8;
+
+	if (n < 1 || max_threads < 1){
+		fprintf(stderr, "Usage: %s [keys in the large tree] [max threads]\n", argv[0]);
+		return 1;
+	}
+
+	// Keys come from a range 4 times the tree size, so trees overlap partly
+	unsigned state = 2463534242u;
+	int* big = malloc(n * sizeof(int));
+	int* small = malloc(n * sizeof(int));
+	if (big == NULL || small == NULL){
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	random_keys(big, n, 4 * n, &state);
+	random_keys(small, n, 4 * n, &state);
+
+	int ratios[] = { 1, 10, 100, 1000 };
+
+	printf("%d keys in the large tree, milliseconds per operation\n", n);
+	printf("%6s %8s %10s %10s %10s %10s %10s\n", "ratio", "threads", "union", "intersect", "difference", "insert", "remove");
+
+	for (int i = 0; i < (int)(sizeof(ratios) / sizeof(ratios[0])); i++){
+		int m = n / ratios[i] > 0 ? n / ratios[i] : 1;
+
+		for (int threads = 1; threads <= max_threads; threads *= 2){
+			// The calling thread works too, so the pool gets one thread less
+			struct thread_pool* pool = threads > 1 ? thread_pool_create(threads - 1) : NULL;
+
+			printf("%6d %8d %10.2f %10.2f %10.2f", ratios[i], threads,
+				time_set_op(AVL_SET_UNION, big, n, small, m, pool),
+				time_set_op(AVL_SET_INTERSECT, big, n, small, m, pool),
+				time_set_op(AVL_SET_DIFFERENCE, big, n, small, m, pool));
+
+			// The key-at-a-time merge runs on one thread only
+			if (threads == 1){
+				printf(" %10.2f %10.2f\n",
+					time_one_by_one(AVL_SET_UNION, big, n, small, m),
+					time_one_by_one(AVL_SET_DIFFERENCE, big, n, small, m));
+			}
+			else{
+				printf(" %10s %10s\n", "-", "-");
+			}
+
+			thread_pool_free(pool);
+		}
+	}
+
+	free(big);
+	free(small);
+
+	return 0;
+}
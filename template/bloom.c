@@ -0,0 +1,179 @@
+/***********************************************************************
+** Program Filename: bloom
+** Date: 10/19/2026
+** Description: Implementation for a split-block Bloom filter. Each element
+maps to one 256-bit block (never straddling a cache line) and sets one bit in
+each of the block's eight 32-bit words, so a lookup costs a single cache miss
+and eight independent bit tests that the compiler can do in one vector op.
+** Input: None
+** Output: None
+*********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "bloom.h"
+
+// Bits budgeted per expected element, about a 1% false-positive rate
+#define BLOOM_BITS_PER_ELEM 10
+
+// Words per block, one bit is set in each
+#define BLOOM_WORDS 8
+
+/*
+ * Odd multipliers used to derive the eight in-word bit positions from one
+ * 32-bit hash (the same salts as the Parquet split-block filter).
+ */
+static const unsigned int bloom_salt[BLOOM_WORDS] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+/*
+ * This is the structure that represents a filter.  Blocks are 32 bytes and
+ * the array is 64-byte aligned, so two blocks share each cache line.
+ */
+struct bloom{
+    unsigned int (*blocks)[BLOOM_WORDS]; // Bit blocks
+    unsigned int n_blocks; // Number of blocks
+    int capacity; // Elements the filter was sized for
+};
+
+/*
+ * This function should allocate an empty filter with enough blocks for
+ * `expected_elems` elements at BLOOM_BITS_PER_ELEM bits each.
+ */
+struct bloom* bloom_create(int expected_elems){
+
+    struct bloom* bloom = malloc(sizeof(struct bloom));
+    if (bloom == NULL){
+        return NULL;
+    }
+
+    if (expected_elems < 1){
+        expected_elems = 1;
+    }
+
+    // Round bits up to whole blocks
+    size_t bits = (size_t)expected_elems * BLOOM_BITS_PER_ELEM;
+    size_t block_bits = BLOOM_WORDS * 32;
+    bloom->n_blocks = (unsigned int)((bits + block_bits - 1) / block_bits);
+    bloom->capacity = expected_elems;
+
+    // aligned_alloc wants a size that is a multiple of the alignment
+    size_t bytes = (size_t)bloom->n_blocks * sizeof(*bloom->blocks);
+    bytes = (bytes + 63) & ~(size_t)63;
+
+    bloom->blocks = aligned_alloc(64, bytes);
+    if (bloom->blocks == NULL){
+        free(bloom);
+        return NULL;
+    }
+    memset(bloom->blocks, 0, bytes);
+
+    return bloom;
+}
+
+/*
+ * This function should free the memory allocated to a given filter.
+ */
+void bloom_free(struct bloom* bloom){
+    if (bloom == NULL){
+        return;
+    }
+    free(bloom->blocks);
+    free(bloom);
+}
+
+/*
+ * This function should reset every bit so that the filter is empty again.
+ */
+void bloom_clear(struct bloom* bloom){
+    memset(bloom->blocks, 0, (size_t)bloom->n_blocks * sizeof(*bloom->blocks));
+}
+
+// Function to pick the block for a hash from its upper 32 bits
+static unsigned int bloom_block_index(struct bloom* bloom, unsigned long long hash){
+    // Multiply-shift maps the range without a division
+    return (unsigned int)(((hash >> 32) * bloom->n_blocks) >> 32);
+}
+
+/*
+ * This function should set one bit in each word of the block selected by
+ * `hash`.  The hash must already be well mixed, e.g. from ht_hash64().
+ */
+void bloom_add(struct bloom* bloom, unsigned long long hash){
+
+    unsigned int* block = bloom->blocks[bloom_block_index(bloom, hash)];
+    unsigned int key = (unsigned int)hash;
+
+#ifdef __AVX2__
+    __m256i salt = _mm256_loadu_si256((const __m256i*)bloom_salt);
+    __m256i shift = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((int)key), salt), 27);
+    __m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), shift);
+    __m256i bits = _mm256_load_si256((const __m256i*)block);
+    _mm256_store_si256((__m256i*)block, _mm256_or_si256(bits, mask));
+#else
+    // Independent lanes, vectorized by the compiler at -O2 and up
+    for (int i = 0; i < BLOOM_WORDS; i++){
+        block[i] |= 1U << ((key * bloom_salt[i]) >> 27);
+    }
+#endif
+}
+
+/*
+ * This function should return 0 if `hash` was definitely never added and 1
+ * if it may have been.
+ */
+int bloom_contains(struct bloom* bloom, unsigned long long hash){
+
+    unsigned int* block = bloom->blocks[bloom_block_index(bloom, hash)];
+    unsigned int key = (unsigned int)hash;
+
+#ifdef __AVX2__
+    __m256i salt = _mm256_loadu_si256((const __m256i*)bloom_salt);
+    __m256i shift = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((int)key), salt), 27);
+    __m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), shift);
+    __m256i bits = _mm256_load_si256((const __m256i*)block);
+
+    // testc is 1 when every bit of mask is also set in bits
+    return _mm256_testc_si256(bits, mask);
+#else
+    // Accumulate misses without branching so the loop stays vectorizable
+    unsigned int missing = 0;
+    for (int i = 0; i < BLOOM_WORDS; i++){
+        unsigned int mask = 1U << ((key * bloom_salt[i]) >> 27);
+        missing |= mask & ~block[i];
+    }
+    return missing == 0;
+#endif
+}
+
+/*
+ * This function returns the number of elements the filter was sized for.
+ * Past this point the false-positive rate climbs above its target.
+ */
+int bloom_capacity(struct bloom* bloom){
+    return bloom->capacity;
+}
+
+/*
+ * This function returns the fraction of bits that are set.  With k = 8 bits
+ * per element the expected false-positive rate is roughly fill^8.
+ */
+double bloom_fill_ratio(struct bloom* bloom){
+
+    unsigned long long set = 0;
+
+    for (unsigned int b = 0; b < bloom->n_blocks; b++){
+        for (int i = 0; i < BLOOM_WORDS; i++){
+            set += __builtin_popcount(bloom->blocks[b][i]);
+        }
+    }
+
+    return (double)set / ((double)bloom->n_blocks * BLOOM_WORDS * 32);
+}
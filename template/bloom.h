@@ -0,0 +1,83 @@
+/*
+ * This file contains the definition of the interface for the blocked Bloom
+ * filter.  You can find descriptions of the filter functions, including their
+ * parameters and their return values, in bloom.c.
+ */
+
+#ifndef __BLOOM_H
+#define __BLOOM_H
+
+/*
+ * Structure used to represent a blocked Bloom filter.
+ */
+struct bloom;
+
+/*
+ * Bloom filter interface function prototypes.  Refer to bloom.c for
+ * documentation about each of these functions.
+ */
+
+/*********************************************************************
+** Function: bloom_create
+** Description: Allocate an empty filter sized for a number of elements
+** Parameters: int expected_elems
+** Pre-Conditions: expected_elems >= 0
+** Post-Conditions: Returns pointer to filter, or NULL if allocation fails
+*********************************************************************/
+struct bloom* bloom_create(int expected_elems);
+
+/*********************************************************************
+** Function: bloom_free
+** Description: Frees memory allocated to a given filter
+** Parameters: struct bloom* bloom
+** Pre-Conditions: none
+** Post-Conditions: Filter and its blocks are freed
+*********************************************************************/
+void bloom_free(struct bloom* bloom);
+
+/*********************************************************************
+** Function: bloom_clear
+** Description: Resets every bit in the filter
+** Parameters: struct bloom* bloom
+** Pre-Conditions: Pointer to filter
+** Post-Conditions: Filter reports no elements
+*********************************************************************/
+void bloom_clear(struct bloom* bloom);
+
+/*********************************************************************
+** Function: bloom_add
+** Description: Sets the bits for a 64-bit hash in its block
+** Parameters: struct bloom* bloom, unsigned long long hash
+** Pre-Conditions: Pointer to filter, well-mixed hash
+** Post-Conditions: bloom_contains(hash) returns 1 from now on
+*********************************************************************/
+void bloom_add(struct bloom* bloom, unsigned long long hash);
+
+/*********************************************************************
+** Function: bloom_contains
+** Description: Tests whether a hash may have been added
+** Parameters: struct bloom* bloom, unsigned long long hash
+** Pre-Conditions: Pointer to filter, well-mixed hash
+** Post-Conditions: Returns 0 if definitely absent, 1 if possibly present
+*********************************************************************/
+int bloom_contains(struct bloom* bloom, unsigned long long hash);
+
+/*********************************************************************
+** Function: bloom_capacity
+** Description: Returns the element count the filter was sized for
+** Parameters: struct bloom* bloom
+** Pre-Conditions: Pointer to filter
+** Post-Conditions: Returns capacity
+*********************************************************************/
+int bloom_capacity(struct bloom* bloom);
+
+/*********************************************************************
+** Function: bloom_fill_ratio
+** Description: Returns the fraction of bits currently set
+** Parameters: struct bloom* bloom
+** Pre-Conditions: Pointer to filter
+** Post-Conditions: Returns value in [0, 1]
+*********************************************************************/
+double bloom_fill_ratio(struct bloom* bloom);
+
+#endif
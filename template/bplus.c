@@ -0,0 +1,931 @@
+/***********************************************************************
+** Program Filename: bplus
+** Date: 10/19/2026
+** Description: Implementation for a cache-conscious B+tree with int keys and
+void* values. Nodes hold BPLUS_KEYS keys in one 64-byte aligned array so a
+node is searched with a few vector compares instead of one pointer hop per key.
+All key/value pairs live in the leaves, which are linked in key order for range
+scans; inner nodes keep the key sum of each child so range sums take
+O(log n) like bst_range_sum. Duplicate keys are allowed, as in the BST.
+** Input: None
+** Output: None
+*********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "bplus.h"
+
+// Fewest keys a node other than the root may hold
+#define BPLUS_MIN_KEYS (BPLUS_KEYS / 2)
+
+/*
+ * Fields shared by every node.  `keys` comes first so it starts on a cache
+ * line; only keys[0 .. n-1] are meaningful.
+ */
+struct bplus_node{
+    int keys[BPLUS_KEYS];
+    int n; // Keys in use
+    int leaf; // 1 for leaves, 0 for inner nodes
+};
+
+/*
+ * An inner node.  Child i holds keys between keys[i-1] and keys[i]
+ * (inclusive, since duplicates may straddle a separator), and sums[i] is the
+ * total of all keys below child i.
+ */
+struct bplus_inner{
+    struct bplus_node head;
+    struct bplus_node* children[BPLUS_KEYS + 1];
+    long long sums[BPLUS_KEYS + 1];
+};
+
+/*
+ * A leaf node.  values[i] belongs to head.keys[i].
+ */
+struct bplus_leaf{
+    struct bplus_node head;
+    void* values[BPLUS_KEYS];
+    struct bplus_leaf* next;
+    struct bplus_leaf* prev;
+};
+
+/*
+ * This is the structure that represents a B+tree.
+ */
+struct bplus{
+    struct bplus_node* root; // Never NULL, an empty tree is one empty leaf
+    int size;
+};
+
+/*
+ * This is the structure that represents an iterator: a leaf and a position
+ * inside it.
+ */
+struct bplus_iterator{
+    struct bplus* bplus;
+    struct bplus_leaf* leaf;
+    int pos;
+};
+
+// Function to allocate a cache-line aligned node of `bytes` bytes
+void* bplus_alloc(size_t bytes){
+    // aligned_alloc wants a size that is a multiple of the alignment
+    return aligned_alloc(64, (bytes + 63) & ~(size_t)63);
+}
+
+// Function to allocate an empty leaf
+struct bplus_leaf* bplus_leaf_create(){
+
+    struct bplus_leaf* leaf = bplus_alloc(sizeof(struct bplus_leaf));
+    if (leaf == NULL){
+        return NULL;
+    }
+
+    leaf->head.n = 0;
+    leaf->head.leaf = 1;
+    leaf->next = NULL;
+    leaf->prev = NULL;
+
+    return leaf;
+}
+
+// Function to allocate an empty inner node
+struct bplus_inner* bplus_inner_create(){
+
+    struct bplus_inner* inner = bplus_alloc(sizeof(struct bplus_inner));
+    if (inner == NULL){
+        return NULL;
+    }
+
+    inner->head.n = 0;
+    inner->head.leaf = 0;
+
+    return inner;
+}
+
+/*
+ * This function should count how many of a node's keys are less than `key`,
+ * or less than or equal to it when `inclusive` is set.  Because the keys are
+ * sorted, that count is the position of the lower (or upper) bound.
+ */
+int bplus_count(struct bplus_node* node, int key, int inclusive){
+
+#if defined(__AVX2__) && BPLUS_KEYS % 8 == 0 && BPLUS_KEYS <= 64
+    // Compare 8 keys per instruction and count the lanes that matched
+    __m256i probe = _mm256_set1_epi32(key);
+    unsigned long long mask = 0;
+
+    for (int i = 0; i < BPLUS_KEYS; i += 8){
+        __m256i keys = _mm256_load_si256((const __m256i*)(node->keys + i));
+        __m256i hit;
+        if (inclusive){
+            // keys <= key is the complement of keys > key
+            hit = _mm256_xor_si256(_mm256_cmpgt_epi32(keys, probe), _mm256_set1_epi32(-1));
+        }
+        else{
+            hit = _mm256_cmpgt_epi32(probe, keys);
+        }
+        mask |= (unsigned long long)(unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(hit)) << i;
+    }
+
+    // Ignore the unused tail of the array
+    if (node->n < 64){
+        mask &= (1ULL << node->n) - 1;
+    }
+
+    return __builtin_popcountll(mask);
+#else
+    // Branch-free count, vectorized by the compiler at -O2 and up
+    int count = 0;
+    for (int i = 0; i < node->n; i++){
+        count += inclusive ? node->keys[i] <= key : node->keys[i] < key;
+    }
+    return count;
+#endif
+}
+
+// Function to add up every key below a node
+long long bplus_node_sum(struct bplus_node* node){
+
+    long long sum = 0;
+
+    if (node->leaf){
+        for (int i = 0; i < node->n; i++){
+            sum += node->keys[i];
+        }
+    }
+    else{
+        struct bplus_inner* inner = (struct bplus_inner*)node;
+        for (int i = 0; i <= node->n; i++){
+            sum += inner->sums[i];
+        }
+    }
+
+    return sum;
+}
+
+/*
+ * This function should allocate and initialize a new, empty B+tree and
+ * return a pointer to it.
+ */
+struct bplus* bplus_create(){
+
+    struct bplus* bplus = malloc(sizeof(struct bplus));
+    if (bplus == NULL){
+        return NULL;
+    }
+
+    struct bplus_leaf* root = bplus_leaf_create();
+    if (root == NULL){
+        free(bplus);
+        return NULL;
+    }
+
+    bplus->root = &root->head;
+    bplus->size = 0;
+
+    return bplus;
+}
+
+// Function to free a node and everything below it
+void bplus_free_node(struct bplus_node* node){
+
+    // Depth is log_B(n), so recursion stays shallow
+    if (!node->leaf){
+        struct bplus_inner* inner = (struct bplus_inner*)node;
+        for (int i = 0; i <= node->n; i++){
+            bplus_free_node(inner->children[i]);
+        }
+    }
+
+    free(node);
+}
+
+/*
+ * This function should free the memory associated with a B+tree.  It does
+ * not free the values stored in it.
+ *
+ * Params:
+ *   bplus - the tree to be destroyed.  May be NULL.
+ */
+void bplus_free(struct bplus* bplus){
+
+    if (bplus == NULL){
+        return;
+    }
+
+    bplus_free_node(bplus->root);
+    free(bplus);
+}
+
+/*
+ * This function should return the number of key/value pairs in a B+tree.
+ */
+int bplus_size(struct bplus* bplus){
+    return bplus->size;
+}
+
+/*
+ * This function should build a B+tree from `n` keys given in sorted order in
+ * O(n) time.  Leaves are filled as evenly as possible (never below half
+ * full), then each level of inner nodes is built over the one below it.
+ *
+ * Params:
+ *   keys - the keys, in non-decreasing order.  May be NULL only if n is 0.
+ *   values - the value for each key, or NULL to store NULL for every key.
+ *   n - the number of keys.
+ *
+ * Return:
+ *   Should return the new tree, or NULL if the keys are not sorted or memory
+ *   could not be allocated.
+ */
+struct bplus* bplus_build_from_sorted(int* keys, void** values, int n){
+
+    // Reject unsorted input, the result would not be a search tree
+    for (int i = 1; i < n; i++){
+        if (keys[i - 1] > keys[i]){
+            return NULL;
+        }
+    }
+
+    struct bplus* bplus = bplus_create();
+    if (bplus == NULL || n <= 0){
+        return bplus;
+    }
+
+    // Count the nodes on every level up front so that allocation can only
+    // fail before the tree is wired together
+    int leaves = (n + BPLUS_KEYS - 1) / BPLUS_KEYS;
+    int total = leaves;
+    for (int count = leaves; count > 1; ){
+        count = (count + BPLUS_KEYS) / (BPLUS_KEYS + 1);
+        total += count;
+    }
+
+    struct bplus_node** nodes = malloc(total * sizeof(struct bplus_node*));
+    int* lows = malloc(leaves * sizeof(int));
+    int made = 0;
+
+    if (nodes != NULL && lows != NULL){
+        // Reuse the empty root as the first leaf
+        nodes[made++] = bplus->root;
+        while (made < total){
+            void* node;
+            if (made < leaves){
+                node = bplus_leaf_create();
+            }
+            else{
+                node = bplus_inner_create();
+            }
+            if (node == NULL){
+                break;
+            }
+            nodes[made++] = node;
+        }
+    }
+
+    if (made < total){
+        // Nothing is linked yet, so each node is freed on its own
+        for (int i = 1; i < made; i++){
+            free(nodes[i]);
+        }
+        free(nodes);
+        free(lows);
+        bplus_free(bplus);
+        return NULL;
+    }
+
+    // Leaves, spreading keys evenly so none is under half full
+    int next_key = 0;
+    for (int i = 0; i < leaves; i++){
+        struct bplus_leaf* leaf = (struct bplus_leaf*)nodes[i];
+        int take = n / leaves + (i < n % leaves);
+
+        memcpy(leaf->head.keys, keys + next_key, take * sizeof(int));
+        for (int j = 0; j < take; j++){
+            leaf->values[j] = values != NULL ? values[next_key + j] : NULL;
+        }
+        leaf->head.n = take;
+        lows[i] = keys[next_key];
+        next_key += take;
+
+        leaf->prev = i > 0 ? (struct bplus_leaf*)nodes[i - 1] : NULL;
+        leaf->next = i + 1 < leaves ? (struct bplus_leaf*)nodes[i + 1] : NULL;
+    }
+
+    // Then each inner level over the one below, until one node is left
+    int level = 0;
+    int count = leaves;
+    while (count > 1){
+        int parents = (count + BPLUS_KEYS) / (BPLUS_KEYS + 1);
+        int next_child = 0;
+
+        for (int i = 0; i < parents; i++){
+            struct bplus_inner* inner = (struct bplus_inner*)nodes[level + count + i];
+            int take = count / parents + (i < count % parents);
+
+            for (int j = 0; j < take; j++){
+                struct bplus_node* child = nodes[level + next_child + j];
+                inner->children[j] = child;
+                inner->sums[j] = bplus_node_sum(child);
+                // A child's separator is the smallest key below it
+                if (j > 0){
+                    inner->head.keys[j - 1] = lows[next_child + j];
+                }
+            }
+            inner->head.n = take - 1;
+
+            lows[i] = lows[next_child];
+            next_child += take;
+        }
+
+        level += count;
+        count = parents;
+    }
+
+    bplus->root = nodes[total - 1];
+    bplus->size = n;
+
+    free(nodes);
+    free(lows);
+
+    return bplus;
+}
+
+// Function to insert key/value below `node`.  If the node had to split, the
+// new right sibling is returned and its separator stored in *sep; otherwise
+// NULL.  *failed is set, with nothing changed, if memory ran out
+struct bplus_node* bplus_insert_node(struct bplus_node* node, int key, void* value, int* sep, int* failed){
+
+    // Duplicates go after equal keys, as in the BST
+    int pos = bplus_count(node, key, 1);
+
+    if (node->leaf){
+        struct bplus_leaf* leaf = (struct bplus_leaf*)node;
+
+        // Room in this leaf, shift the tail up by one
+        if (node->n < BPLUS_KEYS){
+            memmove(node->keys + pos + 1, node->keys + pos, (node->n - pos) * sizeof(int));
+            memmove(leaf->values + pos + 1, leaf->values + pos, (node->n - pos) * sizeof(void*));
+            node->keys[pos] = key;
+            leaf->values[pos] = value;
+            node->n++;
+            return NULL;
+        }
+
+        struct bplus_leaf* right = bplus_leaf_create();
+        if (right == NULL){
+            *failed = 1;
+            return NULL;
+        }
+
+        // Merge the new pair into a full copy, then deal it out
+        int keys[BPLUS_KEYS + 1];
+        void* values[BPLUS_KEYS + 1];
+        memcpy(keys, node->keys, pos * sizeof(int));
+        memcpy(values, leaf->values, pos * sizeof(void*));
+        keys[pos] = key;
+        values[pos] = value;
+        memcpy(keys + pos + 1, node->keys + pos, (BPLUS_KEYS - pos) * sizeof(int));
+        memcpy(values + pos + 1, leaf->values + pos, (BPLUS_KEYS - pos) * sizeof(void*));
+
+        int left_n = (BPLUS_KEYS + 1) / 2;
+        int right_n = BPLUS_KEYS + 1 - left_n;
+        memcpy(node->keys, keys, left_n * sizeof(int));
+        memcpy(leaf->values, values, left_n * sizeof(void*));
+        memcpy(right->head.keys, keys + left_n, right_n * sizeof(int));
+        memcpy(right->values, values + left_n, right_n * sizeof(void*));
+        node->n = left_n;
+        right->head.n = right_n;
+
+        // Keep the leaf chain in order
+        right->next = leaf->next;
+        if (right->next != NULL){
+            right->next->prev = right;
+        }
+        right->prev = leaf;
+        leaf->next = right;
+
+        *sep = right->head.keys[0];
+        return &right->head;
+    }
+
+    struct bplus_inner* inner = (struct bplus_inner*)node;
+
+    // A full node may have to split once the child returns, so get its new
+    // sibling now while failing is still harmless
+    struct bplus_inner* spare = NULL;
+    if (node->n == BPLUS_KEYS){
+        spare = bplus_inner_create();
+        if (spare == NULL){
+            *failed = 1;
+            return NULL;
+        }
+    }
+
+    struct bplus_node* child = inner->children[pos];
+    int child_sep;
+    struct bplus_node* split = bplus_insert_node(child, key, value, &child_sep, failed);
+
+    if (split == NULL){
+        free(spare);
+        if (!*failed){
+            inner->sums[pos] += key;
+        }
+        return NULL;
+    }
+
+    inner->sums[pos] = bplus_node_sum(child);
+    long long split_sum = bplus_node_sum(split);
+
+    // Room for the new child, shift the tail up by one
+    if (node->n < BPLUS_KEYS){
+        memmove(node->keys + pos + 1, node->keys + pos, (node->n - pos) * sizeof(int));
+        memmove(inner->children + pos + 2, inner->children + pos + 1, (node->n - pos) * sizeof(struct bplus_node*));
+        memmove(inner->sums + pos + 2, inner->sums + pos + 1, (node->n - pos) * sizeof(long long));
+        node->keys[pos] = child_sep;
+        inner->children[pos + 1] = split;
+        inner->sums[pos + 1] = split_sum;
+        node->n++;
+        return NULL;
+    }
+
+    // Full, merge the new child into a copy and split around the middle key
+    int keys[BPLUS_KEYS + 1];
+    struct bplus_node* children[BPLUS_KEYS + 2];
+    long long sums[BPLUS_KEYS + 2];
+
+    memcpy(keys, node->keys, pos * sizeof(int));
+    keys[pos] = child_sep;
+    memcpy(keys + pos + 1, node->keys + pos, (BPLUS_KEYS - pos) * sizeof(int));
+
+    memcpy(children, inner->children, (pos + 1) * sizeof(struct bplus_node*));
+    memcpy(sums, inner->sums, (pos + 1) * sizeof(long long));
+    children[pos + 1] = split;
+    sums[pos + 1] = split_sum;
+    memcpy(children + pos + 2, inner->children + pos + 1, (BPLUS_KEYS - pos) * sizeof(struct bplus_node*));
+    memcpy(sums + pos + 2, inner->sums + pos + 1, (BPLUS_KEYS - pos) * sizeof(long long));
+
+    int left_n = (BPLUS_KEYS + 1) / 2;
+    int right_n = BPLUS_KEYS - left_n;
+
+    memcpy(node->keys, keys, left_n * sizeof(int));
+    memcpy(inner->children, children, (left_n + 1) * sizeof(struct bplus_node*));
+    memcpy(inner->sums, sums, (left_n + 1) * sizeof(long long));
+    node->n = left_n;
+
+    // The middle key moves up instead of staying in either half
+    memcpy(spare->head.keys, keys + left_n + 1, right_n * sizeof(int));
+    memcpy(spare->children, children + left_n + 1, (right_n + 1) * sizeof(struct bplus_node*));
+    memcpy(spare->sums, sums + left_n + 1, (right_n + 1) * sizeof(long long));
+    spare->head.n = right_n;
+
+    *sep = keys[left_n];
+    return &spare->head;
+}
+
+/*
+ * This function should insert a new key/value pair into a B+tree.  Equal
+ * keys may be inserted more than once; each is stored.  Nodes that overflow
+ * split in half, and a split root makes the tree one level taller.
+ *
+ * Params:
+ *   bplus - the tree to insert into.  May not be NULL.
+ *   key - the key to insert.
+ *   value - the value to store with it.
+ */
+void bplus_insert(struct bplus* bplus, int key, void* value){
+
+    // A full root may split, get the new root before anything changes
+    struct bplus_inner* new_root = NULL;
+    if (bplus->root->n == BPLUS_KEYS){
+        new_root = bplus_inner_create();
+        if (new_root == NULL){
+            return;
+        }
+    }
+
+    int sep;
+    int failed = 0;
+    struct bplus_node* split = bplus_insert_node(bplus->root, key, value, &sep, &failed);
+
+    if (failed){
+        free(new_root);
+        return;
+    }
+
+    bplus->size++;
+
+    if (split == NULL){
+        free(new_root);
+        return;
+    }
+
+    // Grow a level
+    new_root->head.keys[0] = sep;
+    new_root->head.n = 1;
+    new_root->children[0] = bplus->root;
+    new_root->children[1] = split;
+    new_root->sums[0] = bplus_node_sum(bplus->root);
+    new_root->sums[1] = bplus_node_sum(split);
+    bplus->root = &new_root->head;
+}
+
+// Function to move one key from child i - 1 into child i of `inner`
+void bplus_borrow_left(struct bplus_inner* inner, int i){
+
+    struct bplus_node* left = inner->children[i - 1];
+    struct bplus_node* child = inner->children[i];
+    long long moved;
+
+    memmove(child->keys + 1, child->keys, child->n * sizeof(int));
+
+    if (child->leaf){
+        struct bplus_leaf* l = (struct bplus_leaf*)left;
+        struct bplus_leaf* c = (struct bplus_leaf*)child;
+
+        memmove(c->values + 1, c->values, child->n * sizeof(void*));
+        child->keys[0] = left->keys[left->n - 1];
+        c->values[0] = l->values[left->n - 1];
+        moved = child->keys[0];
+        inner->head.keys[i - 1] = child->keys[0];
+    }
+    else{
+        struct bplus_inner* l = (struct bplus_inner*)left;
+        struct bplus_inner* c = (struct bplus_inner*)child;
+
+        // The separator comes down, the left node's last key goes up
+        memmove(c->children + 1, c->children, (child->n + 1) * sizeof(struct bplus_node*));
+        memmove(c->sums + 1, c->sums, (child->n + 1) * sizeof(long long));
+        child->keys[0] = inner->head.keys[i - 1];
+        c->children[0] = l->children[left->n];
+        c->sums[0] = l->sums[left->n];
+        moved = c->sums[0];
+        inner->head.keys[i - 1] = left->keys[left->n - 1];
+    }
+
+    left->n--;
+    child->n++;
+    inner->sums[i - 1] -= moved;
+    inner->sums[i] += moved;
+}
+
+// Function to move one key from child i + 1 into child i of `inner`
+void bplus_borrow_right(struct bplus_inner* inner, int i){
+
+    struct bplus_node* child = inner->children[i];
+    struct bplus_node* right = inner->children[i + 1];
+    long long moved;
+
+    if (child->leaf){
+        struct bplus_leaf* c = (struct bplus_leaf*)child;
+        struct bplus_leaf* r = (struct bplus_leaf*)right;
+
+        child->keys[child->n] = right->keys[0];
+        c->values[child->n] = r->values[0];
+        moved = right->keys[0];
+
+        memmove(right->keys, right->keys + 1, (right->n - 1) * sizeof(int));
+        memmove(r->values, r->values + 1, (right->n - 1) * sizeof(void*));
+        inner->head.keys[i] = right->keys[0];
+    }
+    else{
+        struct bplus_inner* c = (struct bplus_inner*)child;
+        struct bplus_inner* r = (struct bplus_inner*)right;
+
+        // The separator comes down, the right node's first key goes up
+        child->keys[child->n] = inner->head.keys[i];
+        c->children[child->n + 1] = r->children[0];
+        c->sums[child->n + 1] = r->sums[0];
+        moved = r->sums[0];
+        inner->head.keys[i] = right->keys[0];
+
+        memmove(right->keys, right->keys + 1, (right->n - 1) * sizeof(int));
+        memmove(r->children, r->children + 1, right->n * sizeof(struct bplus_node*));
+        memmove(r->sums, r->sums + 1, right->n * sizeof(long long));
+    }
+
+    right->n--;
+    child->n++;
+    inner->sums[i] += moved;
+    inner->sums[i + 1] -= moved;
+}
+
+// Function to merge child i + 1 of `inner` into child i and free it
+void bplus_merge(struct bplus_inner* inner, int i){
+
+    struct bplus_node* left = inner->children[i];
+    struct bplus_node* right = inner->children[i + 1];
+
+    if (left->leaf){
+        struct bplus_leaf* l = (struct bplus_leaf*)left;
+        struct bplus_leaf* r = (struct bplus_leaf*)right;
+
+        memcpy(left->keys + left->n, right->keys, right->n * sizeof(int));
+        memcpy(l->values + left->n, r->values, right->n * sizeof(void*));
+        left->n += right->n;
+
+        // Unlink the right leaf
+        l->next = r->next;
+        if (l->next != NULL){
+            l->next->prev = l;
+        }
+    }
+    else{
+        struct bplus_inner* l = (struct bplus_inner*)left;
+        struct bplus_inner* r = (struct bplus_inner*)right;
+
+        // The separator comes down between the two halves
+        left->keys[left->n] = inner->head.keys[i];
+        memcpy(left->keys + left->n + 1, right->keys, right->n * sizeof(int));
+        memcpy(l->children + left->n + 1, r->children, (right->n + 1) * sizeof(struct bplus_node*));
+        memcpy(l->sums + left->n + 1, r->sums, (right->n + 1) * sizeof(long long));
+        left->n += right->n + 1;
+    }
+
+    free(right);
+
+    // Drop separator i and child i + 1 from the parent
+    struct bplus_node* node = &inner->head;
+    inner->sums[i] += inner->sums[i + 1];
+    memmove(node->keys + i, node->keys + i + 1, (node->n - i - 1) * sizeof(int));
+    memmove(inner->children + i + 1, inner->children + i + 2, (node->n - i - 1) * sizeof(struct bplus_node*));
+    memmove(inner->sums + i + 1, inner->sums + i + 2, (node->n - i - 1) * sizeof(long long));
+    node->n--;
+}
+
+// Function to remove one pair with `key` below `node`, 1 if one was found
+int bplus_remove_node(struct bplus_node* node, int key){
+
+    int pos = bplus_count(node, key, 0);
+
+    if (node->leaf){
+        struct bplus_leaf* leaf = (struct bplus_leaf*)node;
+
+        if (pos == node->n || node->keys[pos] != key){
+            return 0;
+        }
+
+        memmove(node->keys + pos, node->keys + pos + 1, (node->n - pos - 1) * sizeof(int));
+        memmove(leaf->values + pos, leaf->values + pos + 1, (node->n - pos - 1) * sizeof(void*));
+        node->n--;
+        return 1;
+    }
+
+    struct bplus_inner* inner = (struct bplus_inner*)node;
+
+    // Copies of key may continue past a separator equal to it
+    int found = bplus_remove_node(inner->children[pos], key);
+    while (!found && pos < node->n && node->keys[pos] == key){
+        pos++;
+        found = bplus_remove_node(inner->children[pos], key);
+    }
+
+    if (!found){
+        return 0;
+    }
+
+    inner->sums[pos] -= key;
+
+    // Refill an underfull child from a sibling, or merge it with one
+    if (inner->children[pos]->n < BPLUS_MIN_KEYS){
+        if (pos > 0 && inner->children[pos - 1]->n > BPLUS_MIN_KEYS){
+            bplus_borrow_left(inner, pos);
+        }
+        else if (pos < node->n && inner->children[pos + 1]->n > BPLUS_MIN_KEYS){
+            bplus_borrow_right(inner, pos);
+        }
+        else if (pos > 0){
+            bplus_merge(inner, pos - 1);
+        }
+        else{
+            bplus_merge(inner, pos);
+        }
+    }
+
+    return 1;
+}
+
+/*
+ * This function should remove one key/value pair with the given key from a
+ * B+tree, if there is one.  Underfull nodes borrow from or merge with a
+ * sibling, and a root left with a single child is replaced by it.
+ *
+ * Params:
+ *   bplus - the tree to remove from.  May not be NULL.
+ *   key - the key to remove.
+ */
+void bplus_remove(struct bplus* bplus, int key){
+
+    if (!bplus_remove_node(bplus->root, key)){
+        return;
+    }
+
+    bplus->size--;
+
+    // Shrink a level
+    struct bplus_node* root = bplus->root;
+    if (!root->leaf && root->n == 0){
+        bplus->root = ((struct bplus_inner*)root)->children[0];
+        free(root);
+    }
+}
+
+// Function to find the leaf and position of the first key >= key
+struct bplus_leaf* bplus_lower_bound(struct bplus* bplus, int key, int* pos){
+
+    struct bplus_node* node = bplus->root;
+
+    while (!node->leaf){
+        node = ((struct bplus_inner*)node)->children[bplus_count(node, key, 0)];
+    }
+
+    struct bplus_leaf* leaf = (struct bplus_leaf*)node;
+    *pos = bplus_count(node, key, 0);
+
+    // The bound may be the first key of the next leaf
+    if (*pos == node->n && leaf->next != NULL){
+        leaf = leaf->next;
+        *pos = 0;
+    }
+
+    return leaf;
+}
+
+/*
+ * This function should return the value associated with a key in a B+tree.
+ * If the key was inserted several times, the value of the first copy in key
+ * order is returned.
+ *
+ * Params:
+ *   bplus - the tree to search.  May not be NULL.
+ *   key - the key whose value is to be returned.
+ *
+ * Return:
+ *   Should return the value, or NULL if the key is not in the tree.
+ */
+void* bplus_get(struct bplus* bplus, int key){
+
+    int pos;
+    struct bplus_leaf* leaf = bplus_lower_bound(bplus, key, &pos);
+
+    if (pos < leaf->head.n && leaf->head.keys[pos] == key){
+        return leaf->values[pos];
+    }
+
+    return NULL;
+}
+
+// Function to add up every key below `bound` (or up to it when `inclusive`)
+long long bplus_sum_below(struct bplus* bplus, int bound, int inclusive){
+
+    struct bplus_node* node = bplus->root;
+    long long sum = 0;
+
+    // Whole children left of the path are in range
+    while (!node->leaf){
+        struct bplus_inner* inner = (struct bplus_inner*)node;
+        int i = bplus_count(node, bound, inclusive);
+
+        for (int j = 0; j < i; j++){
+            sum += inner->sums[j];
+        }
+        node = inner->children[i];
+    }
+
+    int i = bplus_count(node, bound, inclusive);
+    for (int j = 0; j < i; j++){
+        sum += node->keys[j];
+    }
+
+    return sum;
+}
+
+/*
+ * This function should return the sum of all keys in a B+tree between
+ * `lower` and `upper` (inclusive), like bst_range_sum().  It walks two
+ * root-to-leaf paths using the per-child sums, so it is O(B log_B n).
+ *
+ * Params:
+ *   bplus - the tree to search.  May not be NULL.
+ *   lower - the lower bound of the range.
+ *   upper - the upper bound of the range.
+ *
+ * Return:
+ *   Should return the sum, or 0 if the range is empty.
+ */
+int bplus_range_sum(struct bplus* bplus, int lower, int upper){
+
+    if (lower > upper){
+        return 0;
+    }
+
+    return (int)(bplus_sum_below(bplus, upper, 1) - bplus_sum_below(bplus, lower, 0));
+}
+
+/*
+ * This function should allocate and initialize an iterator over a B+tree,
+ * starting at its smallest key.  Like the BST iterator, it must not be used
+ * after the tree is changed.
+ *
+ * Params:
+ *   bplus - the tree to iterate over.  May not be NULL.
+ *
+ * Return:
+ *   Should return the iterator, or NULL if memory could not be allocated.
+ */
+struct bplus_iterator* bplus_iterator_create(struct bplus* bplus){
+
+    struct bplus_iterator* iter = malloc(sizeof(struct bplus_iterator));
+    if (iter == NULL){
+        return NULL;
+    }
+
+    // Leftmost leaf
+    struct bplus_node* node = bplus->root;
+    while (!node->leaf){
+        node = ((struct bplus_inner*)node)->children[0];
+    }
+
+    iter->bplus = bplus;
+    iter->leaf = (struct bplus_leaf*)node;
+    iter->pos = 0;
+
+    return iter;
+}
+
+/*
+ * This function should free the memory allocated to an iterator.
+ */
+void bplus_iterator_free(struct bplus_iterator* iter){
+    free(iter);
+}
+
+// Function to move an iterator off the end of its leaf
+void bplus_iterator_settle(struct bplus_iterator* iter){
+    while (iter->leaf != NULL && iter->pos >= iter->leaf->head.n){
+        iter->leaf = iter->leaf->next;
+        iter->pos = 0;
+    }
+}
+
+/*
+ * This function should return 1 if the iterator has another pair to visit
+ * and 0 if it does not.
+ */
+int bplus_iterator_has_next(struct bplus_iterator* iter){
+    bplus_iterator_settle(iter);
+    return iter->leaf != NULL;
+}
+
+/*
+ * This function should return the key of the iterator's current pair, store
+ * its value at `value` (if not NULL) and advance to the next pair in key
+ * order.  Steps within a leaf are array reads; only every BPLUS_KEYS-th step
+ * follows a pointer.
+ *
+ * Params:
+ *   iter - the iterator.  May not be NULL.
+ *   value - where to store the current value, or NULL.
+ *
+ * Return:
+ *   Should return the current key, or 0 (and a NULL value) at the end.
+ */
+int bplus_iterator_next(struct bplus_iterator* iter, void** value){
+
+    bplus_iterator_settle(iter);
+
+    // Nothing left to visit
+    if (iter->leaf == NULL){
+        if (value){
+            *value = NULL;
+        }
+        return 0;
+    }
+
+    int key = iter->leaf->head.keys[iter->pos];
+    if (value){
+        *value = iter->leaf->values[iter->pos];
+    }
+    iter->pos++;
+
+    return key;
+}
+
+/*
+ * This function should move an iterator to the first pair whose key is
+ * greater than or equal to `key`, so that a range scan can start there.
+ * This is O(log n).
+ *
+ * Params:
+ *   iter - the iterator to move.  May not be NULL.
+ *   key - the key to seek to.
+ */
+void bplus_iterator_seek(struct bplus_iterator* iter, int key){
+    iter->leaf = bplus_lower_bound(iter->bplus, key, &iter->pos);
+}
@@ -0,0 +1,118 @@
+/*
+ * This file contains the definition of the interface for the B+tree.  It
+ * offers the same operations as the binary search tree in bst.h.  You can
+ * find descriptions of the B+tree functions, including their parameters and
+ * their return values, in bplus.c.
+ */
+
+#ifndef __BPLUS_H
+#define __BPLUS_H
+
+/*
+ * Keys per node.  32 ints fill two cache lines, so a node search is four
+ * 8-wide vector compares; a multiple of 8 keeps the AVX2 search path.
+ * Define it before including this header (and when compiling bplus.c) to
+ * tune nodes toward pages instead, e.g. 1024 keys for 4KB of keys.
+ */
+#ifndef BPLUS_KEYS
+#define BPLUS_KEYS 32
+#endif
+
+/*
+ * Structure used to represent a B+tree.
+ */
+struct bplus;
+
+/*
+ * B+tree interface function prototypes.  Refer to bplus.c for documentation
+ * about each of these functions.
+ */
+
+/*********************************************************************
+** Function: bplus_create
+** Description: Allocate and initialize a new, empty B+tree
+** Parameters: none
+** Pre-Conditions: none
+** Post-Conditions: Returns pointer to tree, or NULL if allocation fails
+*********************************************************************/
+struct bplus* bplus_create();
+
+/*********************************************************************
+** Function: bplus_build_from_sorted
+** Description: Bulk loads a B+tree from sorted keys in O(n)
+** Parameters: int* keys, void** values, int n
+** Pre-Conditions: keys are in non-decreasing order, values is NULL or has n entries
+** Post-Conditions: Returns pointer to tree, NULL if keys are unsorted or allocation fails
+*********************************************************************/
+struct bplus* bplus_build_from_sorted(int* keys, void** values, int n);
+
+/*********************************************************************
+** Function: bplus_free
+** Description: Frees every node of a B+tree and the tree itself
+** Parameters: struct bplus* bplus
+** Pre-Conditions: none
+** Post-Conditions: Tree is freed, stored values are not
+*********************************************************************/
+void bplus_free(struct bplus* bplus);
+
+/*********************************************************************
+** Function: bplus_size
+** Description: Returns the number of key/value pairs in O(1)
+** Parameters: struct bplus* bplus
+** Pre-Conditions: Pointer to tree
+** Post-Conditions: Returns size
+*********************************************************************/
+int bplus_size(struct bplus* bplus);
+
+/*********************************************************************
+** Function: bplus_insert
+** Description: Inserts a key/value pair, splitting full nodes
+** Parameters: struct bplus* bplus, int key, void* value
+** Pre-Conditions: Pointer to tree
+** Post-Conditions: Pair is stored; duplicates are kept
+*********************************************************************/
+void bplus_insert(struct bplus* bplus, int key, void* value);
+
+/*********************************************************************
+** Function: bplus_remove
+** Description: Removes one pair with a given key, merging underfull nodes
+** Parameters: struct bplus* bplus, int key
+** Pre-Conditions: Pointer to tree
+** Post-Conditions: One matching pair is removed if any exists
+*********************************************************************/
+void bplus_remove(struct bplus* bplus, int key);
+
+/*********************************************************************
+** Function: bplus_get
+** Description: Returns the value stored for a key
+** Parameters: struct bplus* bplus, int key
+** Pre-Conditions: Pointer to tree
+** Post-Conditions: Returns value, NULL if the key is absent
+*********************************************************************/
+void* bplus_get(struct bplus* bplus, int key);
+
+/*********************************************************************
+** Function: bplus_range_sum
+** Description: Sums the keys between a lower and upper bound (inclusive)
+** Parameters: struct bplus* bplus, int lower, int upper
+** Pre-Conditions: Pointer to tree
+** Post-Conditions: Returns sum in O(log n), same result as bst_range_sum
+*********************************************************************/
+int bplus_range_sum(struct bplus* bplus, int lower, int upper);
+
+/*
+ * Structure used to represent a B+tree iterator.
+ */
+struct bplus_iterator;
+
+/*
+ * B+tree iterator interface prototypes.  Refer to bplus.c for documentation
+ * about each of these functions.
+ */
+struct bplus_iterator* bplus_iterator_create(struct bplus* bplus);
+void bplus_iterator_free(struct bplus_iterator* iter);
+int bplus_iterator_has_next(struct bplus_iterator* iter);
+int bplus_iterator_next(struct bplus_iterator* iter, void** value);
+void bplus_iterator_seek(struct bplus_iterator* iter, int key);
+
+#endif
@@ -10,9 +10,13 @@
  */
 
 #include <stdlib.h>
+#include <pthread.h>
 
 #include "bst.h"
-#include "stack.h"
+#include "node_pool.h"
+
+// Below this many keys a parallel build finishes on the current thread
+#define BST_BUILD_GRAIN 16384
 
 /*
  * This structure represents a single node in a BST.  In addition to containing
@@ -20,26 +24,37 @@
  * fields representing the data stored at this node.  The `key` field is an
  * integer value that should be used as an identifier for the data in this
  * node.  Nodes in the BST should be ordered based on this `key` field.  The
- * `value` field stores data associated with the key.
- *
- * You should not modify this structure.
+ * `value` field stores data associated with the key.  The `size` field is
+ * the number of nodes in the subtree rooted here (including this node) and
+ * `sum` is the sum of their keys.  Both are kept up to date by insert and
+ * remove so that size, rank, select and range sums never have to visit every
+ * node.  The `parent` pointer (NULL at the root) lets an iterator step to the
+ * next node without a stack.  The `red` field is the node's color in a
+ * balanced (red-black) tree and is unused otherwise.
  */
 struct bst_node {
   int key;
   void* value;
+  int size;
+  long long sum;
   struct bst_node* left;
   struct bst_node* right;
+  struct bst_node* parent;
+  int red;
 };
 
 
 /*
  * This structure represents an entire BST.  It specifically contains a
- * reference to the root node of the tree.
- *
- * You should not modify this structure.
+ * reference to the root node of the tree, and whether the tree rebalances
+ * itself as a red-black tree.  Every node comes from the tree's own `pool`,
+ * which hands out nodes from large slabs and reuses removed ones, so the
+ * whole tree is freed a slab at a time rather than a node at a time.
  */
 struct bst {
   struct bst_node* root;
+  int balanced;
+  struct node_pool* pool;
 };
 
 /*
@@ -56,51 +71,55 @@ struct bst* bst_create() {
     return NULL;
   }
 
+  // Nodes are carved out of the pool's slabs
+  bst->pool = node_pool_create(sizeof(struct bst_node));
+  if (bst->pool == NULL){
+    free(bst);
+    return NULL;
+  }
+
   // Set root to be NULL
   bst->root = NULL;
+
+  // Plain BST, nodes stay where they are inserted
+  bst->balanced = 0;
   
   // Return pointer to bst
   return bst;
 }
 
-void bst_free_node(struct bst_node* node){
-
-  // If the children of node is NULL, then return back to previous call on stack
-  if (node == NULL){
-    return;
-  }
+/*
+ * This function should allocate and initialize a new, empty, self-balancing
+ * BST and return a pointer to it.  The tree is kept as a red-black tree, so
+ * its height stays below 2 log2(n + 1) whatever order keys arrive in and
+ * insert, remove and get are O(log n) in the worst case.  All other bst
+ * functions work on it unchanged.
+ */
+struct bst* bst_create_balanced() {
 
-  // Pass in left node until we reach a leaf node
-  bst_free_node(node->left);
+  struct bst* bst = bst_create();
 
-  // Pass in right node until we reach a leaf node
-  bst_free_node(node->right);
+  if (bst != NULL){
+    bst->balanced = 1;
+  }
 
-  // Free leaf node 
-  free(node);
-  
-  return;
+  return bst;
 }
+
 /*
  * This function should free the memory associated with a BST.  While this
  * function should up all memory used in the BST itself, it should not free
  * any memory allocated to the pointer values stored in the BST.  This is the
- * responsibility of the caller.
+ * responsibility of the caller.  Nodes are not visited one by one: the
+ * tree's pool frees its slabs, so this is O(n / slab size).
  *
  * Params:
  *   bst - the BST to be destroyed.  May not be NULL.
  */
 void bst_free(struct bst* bst) {
 
-  // If bst is empty
-  if (bst->root == NULL){
-    return;
-  }
-
-  // Pass in root node
-  bst_free_node(bst->root);
-
-  // Set root node to be NULL
+  // Every node goes with its slab
+  node_pool_free(bst->pool);
   bst->root = NULL;
 
   // Free bst itself
@@ -114,76 +133,303 @@ int bst_node_count(struct bst_node* node){
     return 0;
   }
 
-  /*
-  1) Add root node
-  2) Get size of left subtree
-  3) Get size of right subtree
-  */
-  return bst_node_count(node->left) + 1 + bst_node_count(node->right);
+  // Every node stores the size of its subtree
+  return node->size;
+}
+
+long long bst_node_sum(struct bst_node* node){
+  if (node == NULL){
+    return 0;
+  }
+
+  // Every node stores the key sum of its subtree
+  return node->sum;
 }
 
 /*
  * This function should return the total number of elements stored in a given
- * BST.
+ * BST.  The root's subtree size is the whole tree, so this is O(1).
  *
  * Params:
  *   bst - the BST whose elements are to be counted.  May not be NULL.
  */
 int bst_size(struct bst* bst) {
 
-  // If bst is empty
-  if (bst->root == NULL){
-    return 0;
+  // Pass in root node, an empty tree has size 0
+  return bst_node_count(bst->root);
+}
+
+struct bst_node* bst_node_create(struct node_pool* pool, int key, void* value){
+
+  struct bst_node* node = node_pool_alloc(pool);
+  if (node == NULL){
+    return NULL;
   }
 
-  // Pass in root node
-  return bst_node_count(bst->root);
+  // A new node is a leaf, its subtree is just itself
+  node->key = key;
+  node->value = value;
+  node->size = 1;
+  node->sum = key;
+  node->left = NULL;
+  node->right = NULL;
+  node->parent = NULL;
+
+  // New nodes are red so the black height does not change
+  node->red = 1;
+
+  return node;
 }
 
-void insert_node(struct bst_node* node, int key, void* value){
+struct bst_node* insert_node(struct node_pool* pool, struct bst_node* node, int key, void* value){
 
   if (node == NULL){
-    return;
+    return NULL;
+  }
+
+  // Allocate first so a failure leaves sizes and sums untouched
+  struct bst_node* new_node = bst_node_create(pool, key, value);
+  if (new_node == NULL){
+    return NULL;
   }
 
-  // If the value is less than the node's value, add to left subtree
-  if (key < node->key){
-    // If left node is empty, add a new left node 
-    if (node->left == NULL){
-      // Allocate memory to left node
-      node->left = malloc(sizeof(struct bst_node));
+  // Walk down, counting the new node in every subtree it joins
+  while (1){
+    node->size++;
+    node->sum += key;
+
+    // If the value is less than the node's value, add to left subtree
+    if (key < node->key){
+      // If left node is empty, add the new node there
       if (node->left == NULL){
-        return;
+        node->left = new_node;
+        break;
       }
-      // Initialize left node
-      node->left->key = key;
-      node->left->value = value;
-      node->left->left = NULL;
-      node->left->right = NULL;
+      node = node->left;
     }
+    // Repeat process with right subtree, if value is greater than the node's value
     else{
-
-      // If left node has children, recusively call this function and compare the key to its node(s) 
-      insert_node(node->left, key, value);
+      if (node->right == NULL){
+        node->right = new_node;
+        break;
+      }
+      node = node->right;
     }
   }
-  // Repeat process with right subtree, if value is greater than the node's value
+
+  new_node->parent = node;
+
+  return new_node;
+}
+
+/*****************************************************************************
+ **
+ ** Red-black balancing, used only by trees from bst_create_balanced()
+ **
+ *****************************************************************************/
+
+int bst_is_red(struct bst_node* node){
+  // Missing children count as black
+  return node != NULL && node->red;
+}
+
+void bst_node_update(struct bst_node* node){
+  // Recompute the augmented fields from the children
+  node->size = bst_node_count(node->left) + 1 + bst_node_count(node->right);
+  node->sum = bst_node_sum(node->left) + node->key + bst_node_sum(node->right);
+}
+
+void bst_replace_child(struct bst* bst, struct bst_node* parent, struct bst_node* old, struct bst_node* new){
+  // Point whatever pointed at old (a parent or the root) at new
+  if (parent == NULL){
+    bst->root = new;
+  }
+  else if (parent->left == old){
+    parent->left = new;
+  }
   else{
-    if (node->right == NULL){
-      node->right = malloc(sizeof(struct bst_node));
-      if (node->right == NULL){
-        return;
+    parent->right = new;
+  }
+}
+
+void bst_rotate_left(struct bst* bst, struct bst_node* node){
+
+  // The right child moves up, node becomes its left child
+  struct bst_node* child = node->right;
+
+  node->right = child->left;
+  if (node->right != NULL){
+    node->right->parent = node;
+  }
+
+  child->parent = node->parent;
+  bst_replace_child(bst, node->parent, node, child);
+
+  child->left = node;
+  node->parent = child;
+
+  // Child now covers node's old subtree, node lost the child's right side
+  child->size = node->size;
+  child->sum = node->sum;
+  bst_node_update(node);
+}
+
+void bst_rotate_right(struct bst* bst, struct bst_node* node){
+
+  // Mirror of bst_rotate_left
+  struct bst_node* child = node->left;
+
+  node->left = child->right;
+  if (node->left != NULL){
+    node->left->parent = node;
+  }
+
+  child->parent = node->parent;
+  bst_replace_child(bst, node->parent, node, child);
+
+  child->right = node;
+  node->parent = child;
+
+  child->size = node->size;
+  child->sum = node->sum;
+  bst_node_update(node);
+}
+
+void bst_insert_fixup(struct bst* bst, struct bst_node* node){
+  /*
+  The new red node may have a red parent.  While it does:
+    1) Red uncle, recolor and move the problem up two levels
+    2) Black uncle, one or two rotations at the grandparent end it
+  */
+  while (bst_is_red(node->parent)){
+    struct bst_node* parent = node->parent;
+    struct bst_node* grandparent = parent->parent;
+
+    if (parent == grandparent->left){
+      struct bst_node* uncle = grandparent->right;
+
+      // 1) Recolor
+      if (bst_is_red(uncle)){
+        parent->red = 0;
+        uncle->red = 0;
+        grandparent->red = 1;
+        node = grandparent;
+      }
+      // 2) Rotate, first straightening an inner child
+      else{
+        if (node == parent->right){
+          bst_rotate_left(bst, parent);
+          node = parent;
+          parent = node->parent;
+        }
+        parent->red = 0;
+        grandparent->red = 1;
+        bst_rotate_right(bst, grandparent);
       }
-      node->right->key = key;
-      node->right->value = value;
-      node->right->right = NULL;
-      node->right->left = NULL;
     }
+    // Mirror image
     else{
-      insert_node(node->right, key, value);
-    }  
+      struct bst_node* uncle = grandparent->left;
+
+      if (bst_is_red(uncle)){
+        parent->red = 0;
+        uncle->red = 0;
+        grandparent->red = 1;
+        node = grandparent;
+      }
+      else{
+        if (node == parent->left){
+          bst_rotate_right(bst, parent);
+          node = parent;
+          parent = node->parent;
+        }
+        parent->red = 0;
+        grandparent->red = 1;
+        bst_rotate_left(bst, grandparent);
+      }
+    }
+  }
+
+  bst->root->red = 0;
+}
+
+void bst_remove_fixup(struct bst* bst, struct bst_node* node, struct bst_node* parent){
+  /*
+  A black node was removed, so `node` (possibly NULL, with parent `parent`)
+  is one black short.  While it is black and not the root:
+    1) Red sibling, rotate it up so the sibling is black
+    2) Black sibling with black children, recolor it and move up
+    3) Black sibling with a red child, one or two rotations end it
+  */
+  while (node != bst->root && !bst_is_red(node)){
+
+    if (node == parent->left){
+      struct bst_node* sibling = parent->right;
+
+      // 1) Make the sibling black
+      if (bst_is_red(sibling)){
+        sibling->red = 0;
+        parent->red = 1;
+        bst_rotate_left(bst, parent);
+        sibling = parent->right;
+      }
+
+      // 2) Push the missing black up
+      if (!bst_is_red(sibling->left) && !bst_is_red(sibling->right)){
+        sibling->red = 1;
+        node = parent;
+        parent = node->parent;
+      }
+      // 3) Borrow through rotation
+      else{
+        if (!bst_is_red(sibling->right)){
+          sibling->left->red = 0;
+          sibling->red = 1;
+          bst_rotate_right(bst, sibling);
+          sibling = parent->right;
+        }
+        sibling->red = parent->red;
+        parent->red = 0;
+        sibling->right->red = 0;
+        bst_rotate_left(bst, parent);
+        node = bst->root;
+      }
+    }
+    // Mirror image
+    else{
+      struct bst_node* sibling = parent->left;
+
+      if (bst_is_red(sibling)){
+        sibling->red = 0;
+        parent->red = 1;
+        bst_rotate_right(bst, parent);
+        sibling = parent->left;
+      }
+
+      if (!bst_is_red(sibling->left) && !bst_is_red(sibling->right)){
+        sibling->red = 1;
+        node = parent;
+        parent = node->parent;
+      }
+      else{
+        if (!bst_is_red(sibling->left)){
+          sibling->right->red = 0;
+          sibling->red = 1;
+          bst_rotate_left(bst, sibling);
+          sibling = parent->left;
+        }
+        sibling->red = parent->red;
+        parent->red = 0;
+        sibling->left->red = 0;
+        bst_rotate_right(bst, parent);
+        node = bst->root;
+      }
+    }
+  }
+
+  if (node != NULL){
+    node->red = 0;
   }
-  return;
 }
 
 /*
@@ -203,237 +449,295 @@ void insert_node(struct bst_node* node, int key, void* value){
  */
 void bst_insert(struct bst* bst, int key, void* value) {
 
+  struct bst_node* new_node;
+
   // If bst is empty then insert node at root
   if (bst->root == NULL){
-    // Allocate memory to new node
-    struct bst_node* new_node = malloc(sizeof(struct bst_node));
-    
-    // Initialize new_node
-    new_node->value = value;
-    new_node->key = key;
-
-    // Set children to be NULL
-    new_node->left = NULL;
-    new_node->right = NULL;
-
-    // Assign values to root node
+    // Allocate memory to new node and assign it to root node
+    new_node = bst_node_create(bst->pool, key, value);
     bst->root = new_node;
   }
   else{
     // Find available spot for new node starting at root node
-    insert_node(bst->root, key, value);
+    new_node = insert_node(bst->pool, bst->root, key, value);
+  }
+
+  // Restore the red-black properties
+  if (bst->balanced && new_node != NULL){
+    bst_insert_fixup(bst, new_node);
   }
 
   return;
 }
 
-struct bst_node* get_parent_node(struct bst_node* node, int key){
-
-  // Set parent to be NULL initially
-  struct bst_node* parent = NULL; 
-
-  // Traverse nodes
-  while (node != NULL) {
-
-    // Check if node has the key, then return parent node
-    if (node->key == key)
-      return parent;
+struct bst_node* bst_get_node(struct bst_node* node, int key){
 
-    // Set node to be parent and set node to be left node
-    else if (node->key > key){
-      parent = node;
-      node = node->left; 
-    }
+  // Until key has been found or we fall off the tree
+  while (node != NULL){
 
-    // Do the same with right node if key is greater
-    else  {
-      parent = node;
-      node = node->right;
+    // If key is equal to the nodes key, return node
+    if (key == node->key){
+      // Returning pointer to node
+      return node;
     }
 
+    // If key is less than nodes key, move to left subtree, else to right
+    node = key < node->key ? node->left : node->right;
   }
-  // The node with key does not exist 
-  if (node == NULL)
-    return NULL; 
+
+  // Key has not been found
+  return NULL;
 }
 
-void* bst_remove_node(struct bst_node* node, struct bst_node* parent, int key){
+/*
+ * This function should remove a key/value pair with a specified key from a
+ * given BST.  If multiple values with the same key exist in the tree, this
+ * function should remove the first one it encounters (i.e. the one closest to
+ * the root of the tree).
+ *
+ * Params:
+ *   bst - the BST from which a key/value pair is to be removed.  May not
+ *     be NULL.
+ *   key - the key of the key/value pair to be removed from the BST.
+ */
+void bst_remove(struct bst* bst, int key) {
   /*
-  If the current node has the key, then
-    1) Case: 1, bst is empty
-    2) Case: 2, node found is a leaf node
-    3) Case: 3, node found has two child nodes
-    4) Case: 4, node found has either left or right child node
-
-  If the current node doesn't have key, then
-    5) Recursively call function to move through left and right subtrees
+  If the tree has the key, then
+    1) Case: 1, node found has two child nodes, copy the in-order successor
+       into it and remove the successor instead
+    2) Case: 2, node found has at most one child, link its parent to the child
+  Every node on the path loses one from its subtree size and the removed key
+  from its subtree sum.
   */
 
-  // 1) If bst is empty
-  if (node == NULL){
+  // Find node to remove by comparing node and its key
+  struct bst_node* node_to_remove = bst_get_node(bst->root, key);
+
+  // If the node to remove does not exist, return 
+  if (node_to_remove == NULL){
     return;
   }
 
-  // If current node has the key we're looking for
-  if(key == node->key){
-
-    // 2) If key is a leaf node, free node
-    if (node->left == NULL && node->right == NULL){
-      
-      // Update parent's left node if equal to current node
-      if (parent->left == node){
-        parent->left = NULL;
-      }
-
-      // Do the same if right node
-      else if (parent->right == node){
-        parent->right = NULL;
-      }
-      
-      // Finally free leaf node
-      free(node);
-    }
+  // Walk down again, the node is now known to be there, fixing sizes and
+  // remembering the link that points at it
+  struct bst_node** link = &bst->root;
+  while (*link != node_to_remove){
+    (*link)->size--;
+    (*link)->sum -= key;
+    link = key < (*link)->key ? &(*link)->left : &(*link)->right;
+  }
 
-    // 3) If key contains two children, update node to point to in-order successor
-    else if (node->left != NULL && node->right != NULL){
-      
-      // Assign temp node to find in order successor
-      struct bst_node* temp = node->right;
-      
-      // Assign temp parent to track parent of in order successor
-      struct bst_node* temp_parent = node;
-
-      // Traverse to find least greatest node
-      while (temp->left != NULL){
-        temp_parent = temp;
-        temp = temp->left;
-      }
-      
-      // Replace node's data with in order successor's data 
-      node->value = temp->value;
-      node->key = temp->key;
+  // 1) Two children, take the in-order successor's data and remove it
+  if (node_to_remove->left != NULL && node_to_remove->right != NULL){
+    // The node's subtree keeps the successor's key but loses `key`
+    node_to_remove->size--;
+    node_to_remove->sum -= key;
 
-      // Free successor node, go through all cases again
-      bst_remove_node(temp, temp_parent, temp->key); 
+    // Subtrees between here and the successor lose the successor's key
+    struct bst_node* successor = node_to_remove->right;
+    while (successor->left != NULL){
+      successor = successor->left;
     }
 
-    // 4) If key contains a single child, check left and right node
-    else if(node->left != NULL){
-
-      // Update child node to point to node's parent
-      struct bst_node* child;
-      child = node->left;
-
-      if (parent != NULL) {
-        
-        // If node is current parent's left node, assign child left node to the parent
-        if (parent->left == node){
-          parent->left = child;
-        } 
-    
-        // Else, assign right child node to the parent
-        else{
-          parent->right = child;
-        }
-
-        // After reassigning parent's child node, free current node
-        free(node);
-      }
+    link = &node_to_remove->right;
+    while (*link != successor){
+      (*link)->size--;
+      (*link)->sum -= successor->key;
+      link = &(*link)->left;
     }
-    
-    // Do same with right node
-    else if(node->right != NULL){
-      
-      struct bst_node* child;
-      child = node->right;
 
-      if (parent != NULL) {
-
-        if (parent->left == node){
-          parent->left = child;
-        }
-
-        else{
-          parent->right = child;
-        }
+    node_to_remove->key = successor->key;
+    node_to_remove->value = successor->value;
+    node_to_remove = successor;
+  }
 
-        free(node);
-      }
-    }
+  // 2) At most one child left, replace the node with it
+  if (node_to_remove->left != NULL){
+    *link = node_to_remove->left;
   }
-  
-  // 5) If key is less than node's key, check left subtree
-  else if (key < node->key){
-    if (node->left != NULL){
-      bst_remove_node(node->left, parent, key);
-    }
+  else{
+    *link = node_to_remove->right;
+  }
+  if (*link != NULL){
+    (*link)->parent = node_to_remove->parent;
   }
 
-  // Check right subtree
-  else if (key > node->key){
-    if (node->right != NULL){
-      bst_remove_node(node->right, parent, key);
-    }
+  // Removing a black node leaves its side one black short
+  if (bst->balanced && !node_to_remove->red){
+    bst_remove_fixup(bst, *link, node_to_remove->parent);
   }
 
+  // Back to the pool for the next insert
+  node_pool_release(bst->pool, node_to_remove);
+  
   return;
 }
 
-struct bst_node* bst_get_node(struct bst_node* node, int key){
+/*
+ * This structure describes one piece of a bulk build: the nodes for the
+ * sorted positions [lo, hi) hang below `parent`, and may be split across up
+ * to `threads` threads.
+ */
+struct bst_build_job {
+  struct bst_node* block;
+  int* keys;
+  void** values;
+  int lo;
+  int hi;
+  int depth;
+  int red_depth;
+  struct bst_node* parent;
+  int threads;
+  struct bst_node* root;
+};
 
-  // If key has not been found
-  if (node == NULL){
-    return NULL;
+void* bst_build_worker(void* arg);
+
+// Function to build the subtree for job->lo .. job->hi - 1 into job->root
+void bst_build_range(struct bst_build_job* job){
+
+  if (job->lo >= job->hi){
+    job->root = NULL;
+    return;
   }
 
-  // If key is equal to the nodes key, return node
-  if (key == node->key){
-    // Returning pointer to node
-    return node;
+  // The median is the root, and the node for position i is block[i]
+  int mid = job->lo + (job->hi - job->lo) / 2;
+  struct bst_node* node = &job->block[mid];
+
+  node->key = job->keys[mid];
+  node->value = job->values != NULL ? job->values[mid] : NULL;
+  node->size = job->hi - job->lo;
+  node->parent = job->parent;
+  node->red = job->depth == job->red_depth;
+
+  struct bst_build_job left = *job;
+  left.hi = mid;
+  left.depth = job->depth + 1;
+  left.parent = node;
+
+  struct bst_build_job right = *job;
+  right.lo = mid + 1;
+  right.depth = job->depth + 1;
+  right.parent = node;
+
+  // Hand the left half to a new thread while this one builds the right
+  pthread_t thread;
+  int spawned = 0;
+  if (job->threads > 1 && job->hi - job->lo > BST_BUILD_GRAIN){
+    left.threads = job->threads / 2;
+    right.threads = job->threads - left.threads;
+    spawned = !pthread_create(&thread, NULL, bst_build_worker, &left);
   }
-  // If key is less than nodes key, move to left subtree
-  if (key < node->key){
-    return bst_get_node(node->left, key);
+
+  if (!spawned){
+    bst_build_range(&left);
   }
-  // Move to right subtree
-  else{
-    return bst_get_node(node->right, key);
+  bst_build_range(&right);
+  if (spawned){
+    pthread_join(thread, NULL);
   }
+
+  node->left = left.root;
+  node->right = right.root;
+  node->sum = bst_node_sum(node->left) + node->key + bst_node_sum(node->right);
+
+  job->root = node;
+}
+
+// Function to run a build job on its own thread
+void* bst_build_worker(void* arg){
+  bst_build_range(arg);
+  return NULL;
 }
 
 /*
- * This function should remove a key/value pair with a specified key from a
- * given BST.  If multiple values with the same key exist in the tree, this
- * function should remove the first one it encounters (i.e. the one closest to
- * the root of the tree).
+ * This function should build a BST from `n` keys given in sorted order, in
+ * O(n) time, using up to `n_threads` threads.  All nodes are allocated in a
+ * single slab, laid out in key order, and the tree is height-balanced: the
+ * median of every range becomes the root of its subtree.
+ *
+ * The result is a red-black tree, as from bst_create_balanced(): every level
+ * but the last is full, so coloring the last level red (when it is not full)
+ * and everything else black satisfies the red-black rules, and later inserts
+ * and removes keep the tree balanced.  Removed nodes go back to the tree's
+ * pool like any others.
+ *
+ * With more than one thread, the left and right subtrees of the top levels
+ * are built on separate threads.  Ranges smaller than BST_BUILD_GRAIN keys
+ * are built on one thread, where a thread would cost more than it saves.
  *
  * Params:
- *   bst - the BST from which a key/value pair is to be removed.  May not
- *     be NULL.
- *   key - the key of the key/value pair to be removed from the BST.
+ *   keys - the keys, in non-decreasing order.  May be NULL only if n is 0.
+ *   values - the value for each key, or NULL to store NULL for every key.
+ *   n - the number of keys.
+ *   n_threads - the most threads to build with.  1 builds on the caller's
+ *     thread only.
+ *
+ * Return:
+ *   Should return the new BST, or NULL if the keys are not sorted or memory
+ *   could not be allocated.
  */
-void bst_remove(struct bst* bst, int key) {
-  
-  // If bst empty
-  if (bst->root == NULL){
-    return;
+struct bst* bst_build_from_sorted_parallel(int* keys, void** values, int n, int n_threads) {
+
+  // Reject unsorted input, the result would not be a search tree
+  for (int i = 1; i < n; i++){
+    if (keys[i - 1] > keys[i]){
+      return NULL;
+    }
   }
 
-  // Find node to remove by comparing node and its key
-  struct bst_node* node_to_remove = bst_get_node(bst->root, key);
+  struct bst* bst = bst_create_balanced();
+  if (bst == NULL || n <= 0){
+    return bst;
+  }
 
-  // Get parent of node with key
-  struct bst_node* parent = get_parent_node(bst->root, key);
+  struct bst_node* block = node_pool_alloc_array(bst->pool, n);
+  if (block == NULL){
+    bst_free(bst);
+    return NULL;
+  }
 
-  // If the node to remove does not exist, return 
-  if (node_to_remove == NULL){
-    return;
+  // The tree has ceil(log2(n + 1)) levels, the last one is red unless full
+  int levels = 0;
+  while (levels < 31 && (1 << levels) - 1 < n){
+    levels++;
   }
+  int red_depth = (1LL << levels) - 1 == n ? -1 : levels - 1;
+
+  struct bst_build_job job;
+  job.block = block;
+  job.keys = keys;
+  job.values = values;
+  job.lo = 0;
+  job.hi = n;
+  job.depth = 0;
+  job.red_depth = red_depth;
+  job.parent = NULL;
+  job.threads = n_threads;
+  job.root = NULL;
+
+  bst_build_range(&job);
+  bst->root = job.root;
 
-  // Pass in the node with key, the parent, and key
-  bst_remove_node(node_to_remove, parent, key);
-  
-  return;
+  return bst;
+}
+
+/*
+ * This function should build a BST from `n` keys given in sorted order on
+ * the caller's thread.  See bst_build_from_sorted_parallel() for details.
+ *
+ * Params:
+ *   keys - the keys, in non-decreasing order.  May be NULL only if n is 0.
+ *   values - the value for each key, or NULL to store NULL for every key.
+ *   n - the number of keys.
+ *
+ * Return:
+ *   Should return the new BST, or NULL if the keys are not sorted or memory
+ *   could not be allocated.
+ */
+struct bst* bst_build_from_sorted(int* keys, void** values, int n) {
+  return bst_build_from_sorted_parallel(keys, values, n, 1);
 }
 
 /*
@@ -471,6 +775,83 @@ void* bst_get(struct bst* bst, int key) {
   return temp->value;
 }
 
+/*
+ * This function should return the rank of a key in a given BST, i.e. the
+ * number of keys in the tree that are strictly less than `key`.  The key does
+ * not need to be in the tree.  Each step down either skips a whole left
+ * subtree (using its stored size) or not, so this is O(height).
+ *
+ * Params:
+ *   bst - the BST in which to rank `key`.  May not be NULL.
+ *   key - the key to rank.
+ *
+ * Return:
+ *   Should return the number of keys in `bst` less than `key`.
+ */
+int bst_rank(struct bst* bst, int key) {
+
+  struct bst_node* node = bst->root;
+  int rank = 0;
+
+  while (node != NULL){
+    // Node and its left subtree are all below key
+    if (node->key < key){
+      rank += bst_node_count(node->left) + 1;
+      node = node->right;
+    }
+    // Keys below `key` can only be in the left subtree
+    else{
+      node = node->left;
+    }
+  }
+
+  return rank;
+}
+
+/*
+ * This function should return the k-th smallest key of a given BST, counting
+ * from 0, so that bst_select(bst, bst_rank(bst, key)) == key for any key in
+ * the tree.  Percentile p is bst_select(bst, p * (bst_size(bst) - 1) / 100).
+ * Like bst_rank() this is O(height).
+ *
+ * Params:
+ *   bst - the BST to select from.  May not be NULL.
+ *   k - the position to select, 0 <= k < bst_size(bst).
+ *
+ * Return:
+ *   Should return the key at position `k` in sorted order, or 0 if `k` is
+ *   out of range.
+ */
+int bst_select(struct bst* bst, int k) {
+
+  struct bst_node* node = bst->root;
+
+  // Out of range
+  if (k < 0 || k >= bst_size(bst)){
+    return 0;
+  }
+
+  while (node != NULL){
+    int left_size = bst_node_count(node->left);
+
+    // The k-th key is in the left subtree
+    if (k < left_size){
+      node = node->left;
+    }
+    // Skip the left subtree and this node
+    else if (k > left_size){
+      k -= left_size + 1;
+      node = node->right;
+    }
+    // Exactly left_size keys come before this node
+    else{
+      return node->key;
+    }
+  }
+
+  return 0;
+}
+
 
 
 /*****************************************************************************
@@ -479,30 +860,56 @@ void* bst_get(struct bst* bst, int key) {
  **
  *****************************************************************************/
 
-void* bst_height_node(struct bst_node* node){
+int bst_height_node(struct bst_node* node){
 
   // If bst is empty
   if (node == NULL){
       return -1;
   }
-  
-  // If root has no children
-  if (node->left == NULL && node->right == NULL){
-    return 0;
-  }
 
-  // Store size of left and right subtree
-  int leftmaxdepth = bst_height_node(node->left);
-  int rightmaxdepth = bst_height_node(node->right);
+  /*
+  Walk the whole subtree with parent pointers instead of recursion, tracking
+  where we came from:
+    1) From the parent, go left, else right, else back up
+    2) From the left child, go right, else back up
+    3) From the right child, go back up
+  */
+  struct bst_node* stop = node->parent;
+  struct bst_node* prev = stop;
+  int depth = 0;
+  int height = 0;
+
+  while (node != stop){
+    struct bst_node* next;
+
+    // 1) First visit, this is the deepest point of the path so far
+    if (prev == node->parent){
+      if (depth > height){
+        height = depth;
+      }
+      next = node->left != NULL ? node->left : node->right;
+    }
+    // 2) Left subtree done
+    else if (prev == node->left){
+      next = node->right;
+    }
+    // 3) Right subtree done
+    else{
+      next = NULL;
+    }
 
-  // If left subtree is greater than right, return left subtree size + root
-  if (leftmaxdepth > rightmaxdepth){
-    return 1 + leftmaxdepth;
-  }
-  // Return right subtree size + root
-  else{
-    return 1 + rightmaxdepth;
+    prev = node;
+    if (next != NULL){
+      node = next;
+      depth++;
+    }
+    else{
+      node = node->parent;
+      depth--;
+    }
   }
+
+  return height;
 }
 
 /*
@@ -577,33 +984,31 @@ int bst_path_sum(struct bst* bst, int sum) {
 
 }
 
-int bst_range_sum_node(struct bst_node* node, int lower, int upper){
-  
-  // If bst empty
-  if (node == NULL){
-    return 0;
-  }
+long long bst_sum_below(struct bst_node* node, int bound, int inclusive){
 
-  // If node's value is greater than upper bound, explore left subtree, look for smaller values
-  if (node->key > upper){
-    return bst_range_sum_node(node->left, lower, upper);
-  }
-  
-  // If node's value is less than lower bound, explore right subtree, look for larger values
-  if (node->key < lower){
-    return bst_range_sum_node(node->right, lower, upper);
-  }
+  long long sum = 0;
 
-  // If value is within range, add key and recursively look in left and right nodes
-  return node->key + bst_range_sum_node(node->left, lower, upper) + bst_range_sum_node(node->right, lower, upper);
+  // One walk from the root, adding whole left subtrees that are in range
+  while (node != NULL){
+    if (node->key < bound || (inclusive && node->key == bound)){
+      sum += bst_node_sum(node->left) + node->key;
+      node = node->right;
+    }
+    else{
+      node = node->left;
+    }
+  }
 
-} 
+  return sum;
+}
 
 /*
  * This function should compute a range sum in a given BST.  Specifically, it
  * should compute the sum of all keys in the BST between a given lower bound
  * and a given upper bound.  For full credit, you should not process any subtree
- * whose keys cannot be included in the range sum.
+ * whose keys cannot be included in the range sum.  The sum is the keys up to
+ * `upper` minus the keys below `lower`, each found in one root-to-leaf walk
+ * using the stored subtree sums, so this is O(height) however wide the range.
  *
  * Params:
  *   bst - the BST within which to compute a range sum
@@ -619,13 +1024,13 @@ int bst_range_sum_node(struct bst_node* node, int lower, int upper){
  */
 int bst_range_sum(struct bst* bst, int lower, int upper) {
   
-  // if bst empty
-  if (bst->root == NULL){
+  // if bst or the range is empty
+  if (bst->root == NULL || lower > upper){
     return 0;
   }
 
   // Return range sum
-  return bst_range_sum_node(bst->root, lower, upper);
+  return (int)(bst_sum_below(bst->root, upper, 1) - bst_sum_below(bst->root, lower, 0));
 }
 
 /*****************************************************************************
@@ -636,26 +1041,56 @@ int bst_range_sum(struct bst* bst, int lower, int upper) {
 
 /*
  * Structure used to represent a binary search tree iterator.  It contains
- * only a reference to a stack to be used to implement the iterator.
- *
- * You should not modify this structure.
+ * only the node to be returned next; the following node is found through
+ * the tree's parent pointers, so stepping never allocates memory.
  */
 struct bst_iterator {
-  struct stack* stack;
+  struct bst* bst;
+  struct bst_node* next;
 };
 
+struct bst_node* bst_leftmost_node(struct bst_node* node){
+  while (node != NULL && node->left != NULL){
+    node = node->left;
+  }
+  return node;
+}
+
+struct bst_node* bst_successor_node(struct bst_node* node){
+
+  // Smallest key of the right subtree comes next
+  if (node->right != NULL){
+    return bst_leftmost_node(node->right);
+  }
+
+  // Otherwise climb until coming up from a left child
+  while (node->parent != NULL && node == node->parent->right){
+    node = node->parent;
+  }
+  return node->parent;
+}
+
 /*
  * This function should allocate and initialize an iterator over a specified
- * BST and return a pointer to that iterator.
+ * BST and return a pointer to that iterator.  The iterator starts at the
+ * smallest key.  Only the iterator itself is allocated; stepping through the
+ * tree uses no further memory.  The BST must not be modified while the
+ * iterator is in use.
  *
  * Params:
  *   bst - the BST for over which to create an iterator.  May not be NULL.
  */
 struct bst_iterator* bst_iterator_create(struct bst* bst) {
-  /*
-   * FIXME:
-   */
-  return NULL;
+
+  struct bst_iterator* iter = malloc(sizeof(struct bst_iterator));
+  if (iter == NULL){
+    return NULL;
+  }
+
+  iter->bst = bst;
+  iter->next = bst_leftmost_node(bst->root);
+
+  return iter;
 }
 
 /*
@@ -667,9 +1102,7 @@ struct bst_iterator* bst_iterator_create(struct bst* bst) {
  *   iter - the BST iterator to be destroyed.  May not be NULL.
  */
 void bst_iterator_free(struct bst_iterator* iter) {
-  /*
-   * FIXME:
-   */
+  free(iter);
   return;
 }
 
@@ -684,10 +1117,7 @@ void bst_iterator_free(struct bst_iterator* iter) {
  *     not be NULL.
  */
 int bst_iterator_has_next(struct bst_iterator* iter) {
-  /*
-   * FIXME:
-   */
-  return 0;
+  return iter->next != NULL;
 }
 
 /*
@@ -704,6 +1134,9 @@ int bst_iterator_has_next(struct bst_iterator* iter) {
  *
  *   *value = current_node->value;
  *
+ * Stepping is amortized O(1): over a full scan every edge is walked once
+ * down and once up.
+ *
  * Parameters:
  *   iter - BST iterator.  The key and value associated with this iterator's
  *     current node should be returned, and the iterator should be updated to
@@ -716,11 +1149,51 @@ int bst_iterator_has_next(struct bst_iterator* iter) {
  *   pointed to by `iter`.
  */
 int bst_iterator_next(struct bst_iterator* iter, void** value) {
-  /*
-   * FIXME:
-   */
+
+  struct bst_node* current = iter->next;
+
+  // Nothing left to visit
+  if (current == NULL){
+    if (value) {
+      *value = NULL;
+    }
+    return 0;
+  }
+
+  iter->next = bst_successor_node(current);
+
   if (value) {
-    *value = NULL;
+    *value = current->value;
   }
-  return 0;
+  return current->key;
+}
+
+/*
+ * This function should move a BST iterator to the first node whose key is
+ * greater than or equal to `key` (the lower bound), so that a scan can start
+ * in the middle of the tree.  This is O(height).
+ *
+ * Params:
+ *   iter - the BST iterator to move.  May not be NULL.
+ *   key - the key to seek to.
+ */
+void bst_iterator_seek(struct bst_iterator* iter, int key) {
+
+  struct bst_node* node = iter->bst->root;
+  struct bst_node* bound = NULL;
+
+  while (node != NULL){
+    // Candidate, but a smaller one may be on the left
+    if (node->key >= key){
+      bound = node;
+      node = node->left;
+    }
+    else{
+      node = node->right;
+    }
+  }
+
+  iter->next = bound;
+
+  return;
 }
@@ -26,9 +26,37 @@ struct bst;
 *********************************************************************/
 struct bst* bst_create();
 
+/********************************************************************* 
+** Function: bst_create_balanced
+** Description: Allocate and initialize a new, empty, self-balancing (red-black) BST.
+** Parameters: none
+** Pre-Conditions: none
+** Post-Conditions: Return bst pointer. Insert, remove and get are O(log n).
+*********************************************************************/
+struct bst* bst_create_balanced();
+
+/********************************************************************* 
+** Function: bst_build_from_sorted
+** Description: Builds a height-balanced (red-black) BST from sorted keys in O(n),
+with every node in one contiguous block.
+** Parameters: int* keys, void** values, int n
+** Pre-Conditions: keys are in non-decreasing order, values is NULL or has n entries
+** Post-Conditions: Return bst pointer, NULL if keys are unsorted or allocation fails.
+*********************************************************************/
+struct bst* bst_build_from_sorted(int* keys, void** values, int n);
+
+/********************************************************************* 
+** Function: bst_build_from_sorted_parallel
+** Description: Same as bst_build_from_sorted, building subtrees on up to n_threads threads.
+** Parameters: int* keys, void** values, int n, int n_threads
+** Pre-Conditions: keys are in non-decreasing order, values is NULL or has n entries
+** Post-Conditions: Return bst pointer, NULL if keys are unsorted or allocation fails.
+*********************************************************************/
+struct bst* bst_build_from_sorted_parallel(int* keys, void** values, int n, int n_threads);
+
 /********************************************************************* 
 ** Function: bst_free
-** Description: Recursively free nodes in a given BST. Frees BST itself.
+** Description: Frees the nodes of a given BST a slab at a time. Frees BST itself.
 ** Parameters: struct bst* bst
 ** Pre-Conditions: Pointer to bst.
 ** Post-Conditions: BST nodes are properly freed and BST struct is freed.
@@ -37,7 +65,7 @@ void bst_free(struct bst* bst);
 
 /********************************************************************* 
 ** Function: bst_size
-** Description: Returns the number of elements in a given BST.
+** Description: Returns the number of elements in a given BST in O(1).
 ** Parameters: struct bst* bst
 ** Pre-Conditions: Pointer to bst
 ** Post-Conditions: Returns the size of the BST
@@ -74,6 +102,24 @@ void bst_remove(struct bst* bst, int key);
 *********************************************************************/
 void* bst_get(struct bst* bst, int key);
 
+/********************************************************************* 
+** Function: bst_rank
+** Description: Returns the number of keys in a BST less than a given key.
+** Parameters: struct bst* bst, int key
+** Pre-Conditions: Pointer to bst, key does not need to be in the bst
+** Post-Conditions: Returns rank of key in O(height)
+*********************************************************************/
+int bst_rank(struct bst* bst, int key);
+
+/********************************************************************* 
+** Function: bst_select
+** Description: Returns the k-th smallest key in a BST, counting from 0.
+** Parameters: struct bst* bst, int k
+** Pre-Conditions: Pointer to bst, 0 <= k < bst_size(bst)
+** Post-Conditions: Returns key at position k in O(height), 0 if out of range
+*********************************************************************/
+int bst_select(struct bst* bst, int k);
+
 /*
  * Binary search tree "puzzle" function prototypes.  Refer to bst.c for
  * documentation about each of these functions.
@@ -118,5 +164,6 @@ struct bst_iterator* bst_iterator_create(struct bst* bst);
 void bst_iterator_free(struct bst_iterator* iter);
 int bst_iterator_has_next(struct bst_iterator* iter);
 int bst_iterator_next(struct bst_iterator* iter, void** value);
+void bst_iterator_seek(struct bst_iterator* iter, int key);
 
 #endif
@@ -0,0 +1,250 @@
+/***********************************************************************
+** Program Filename: bst_bench
+** Date: 10/19/2026
+** Description: Times the binary search tree's augmented queries on a large
+tree. bst_size, bst_rank and bst_select read the subtree sizes kept in every
+node, so they are timed per call, and percentiles read by bst_select are set
+against finding the same key by walking an iterator k steps, which is what
+answering them without the sizes would cost. bst_range_sum reads the subtree
+key sums, so it is timed over ranges of growing width against adding up the
+range with an iterator. Last, whole trees are built by sorted and by random
+inserts, with and without balancing, and insert, lookup, bst_height and
+bst_free are timed on each.
+** Input: bst_bench [keys], 10000000 by default
+** Output: Nanoseconds per call of each query, and per key for whole trees
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "bst.h"
+
+// Queries timed per test
+#define QUERIES 1000000
+
+// Range sums timed per width, and per width for the iterator, which is slow
+#define RANGE_QUERIES 100000
+#define WALK_QUERIES 1000
+
+// Widest range summed with the iterator
+#define WALK_MAX_WIDTH 100000
+
+// Sorted inserts without balancing make a list and cost O(n^2) in all, so
+// that test stops at this many keys
+#define SORTED_PLAIN_MAX 50000
+
+// Function to return a monotonic time in seconds
+double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Function to return the next number of a xorshift generator
+unsigned next_random(unsigned* state){
+	unsigned x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+// Function to time size, rank and select on a tree holding the keys 0, 2,
+// 4, ... 2 * (n - 1)
+void bench_order_statistics(struct bst* bst, int n){
+	unsigned state = 2463534242u;
+	long long sink = 0;
+	double t;
+
+	printf("order statistics, %d keys\n", n);
+
+	t = now();
+	for (int i = 0; i < QUERIES; i++){
+		sink += bst_size(bst);
+	}
+	printf("  bst_size             %10.1f ns\n", (now() - t) * 1e9 / QUERIES);
+
+	t = now();
+	for (int i = 0; i < QUERIES; i++){
+		sink += bst_rank(bst, (int)(next_random(&state) % (2u * n)));
+	}
+	printf("  bst_rank, random     %10.1f ns\n", (now() - t) * 1e9 / QUERIES);
+
+	t = now();
+	for (int i = 0; i < QUERIES; i++){
+		sink += bst_select(bst, (int)(next_random(&state) % (unsigned)n));
+	}
+	printf("  bst_select, random   %10.1f ns\n", (now() - t) * 1e9 / QUERIES);
+
+	// Every percentile from 1 to 99, the way a latency report reads them
+	int rounds = QUERIES / 99;
+	t = now();
+	for (int r = 0; r < rounds; r++){
+		for (int p = 1; p <= 99; p++){
+			sink += bst_select(bst, (int)((long long)n * p / 100));
+		}
+	}
+	printf("  bst_select, p1..p99  %10.1f ns\n", (now() - t) * 1e9 / (rounds * 99.0));
+
+	// The median found by walking, as without subtree sizes
+	t = now();
+	struct bst_iterator* iter = bst_iterator_create(bst);
+	for (int i = 0; i < n / 2 && bst_iterator_has_next(iter); i++){
+		bst_iterator_next(iter, NULL);
+	}
+	sink += bst_iterator_next(iter, NULL);
+	bst_iterator_free(iter);
+	printf("  median by iterator   %10.1f ms\n", (now() - t) * 1e3);
+
+	if (sink == 0){
+		printf("  (no keys found)\n");
+	}
+}
+
+// Function to time bst_range_sum and an iterator walk over random ranges
+// of growing width, on the same tree
+void bench_range_sum(struct bst* bst, int n){
+	unsigned state = 2463534242u;
+	long long sink = 0;
+
+	printf("range sums, %d keys\n", n);
+	printf("  %10s %14s %14s\n", "keys", "range_sum ns", "iterator ns");
+
+	for (long long width = 1; width <= n; width *= 10){
+		// Ranges of `width` keys starting at a random key
+		double t = now();
+		for (int i = 0; i < RANGE_QUERIES; i++){
+			int first = (int)(next_random(&state) % (unsigned)(n - width + 1));
+			sink += bst_range_sum(bst, 2 * first, 2 * (int)(first + width - 1));
+		}
+		double sum_ns = (now() - t) * 1e9 / RANGE_QUERIES;
+
+		if (width > WALK_MAX_WIDTH){
+			printf("  %10lld %14.1f %14s\n", width, sum_ns, "-");
+			continue;
+		}
+
+		t = now();
+		for (int i = 0; i < WALK_QUERIES; i++){
+			int first = (int)(next_random(&state) % (unsigned)(n - width + 1));
+			struct bst_iterator* iter = bst_iterator_create(bst);
+			bst_iterator_seek(iter, 2 * first);
+			for (long long k = 0; k < width && bst_iterator_has_next(iter); k++){
+				sink += bst_iterator_next(iter, NULL);
+			}
+			bst_iterator_free(iter);
+		}
+		printf("  %10lld %14.1f %14.1f\n", width, sum_ns, (now() - t) * 1e9 / WALK_QUERIES);
+	}
+
+	if (sink == 0){
+		printf("  (no keys found)\n");
+	}
+}
+
+// Function to build one tree from keys[0..n) in the given order and time
+// insert, lookup, height and teardown on it
+void bench_insert_order(const char* order, int balanced, int* keys, int n){
+	unsigned state = 2463534242u;
+	long long sink = 0;
+
+	struct bst* bst = balanced ? bst_create_balanced() : bst_create();
+	if (bst == NULL){
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	double t = now();
+	for (int i = 0; i < n; i++){
+		bst_insert(bst, keys[i], &keys[i]);
+	}
+	double insert = now() - t;
+
+	int lookups = n < QUERIES ? n : QUERIES;
+	t = now();
+	for (int i = 0; i < lookups; i++){
+		sink += bst_get(bst, keys[next_random(&state) % (unsigned)n]) != NULL;
+	}
+	double get = now() - t;
+
+	t = now();
+	int height = bst_height(bst);
+	double height_time = now() - t;
+
+	t = now();
+	bst_free(bst);
+	double free_time = now() - t;
+
+	printf("  %-7s %-8s %9d %10.1f %10.1f %9d %10.1f %10.1f%s\n", order, balanced ? "balanced" : "plain", n,
+		insert * 1e9 / n, get * 1e9 / lookups, height, height_time * 1e3, free_time * 1e3,
+		sink != lookups ? " (keys missing)" : "");
+}
+
+// Function to time whole trees built by sorted and random inserts
+void bench_insert(int* shuffled, int n){
+	int* sorted = malloc(n * sizeof(int));
+	if (sorted == NULL){
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+	for (int i = 0; i < n; i++){
+		sorted[i] = 2 * i;
+	}
+
+	printf("whole trees\n");
+	printf("  %-7s %-8s %9s %10s %10s %9s %10s %10s\n", "order", "mode", "keys", "insert ns", "get ns", "height", "height ms", "free ms");
+
+	bench_insert_order("random", 0, shuffled, n);
+	bench_insert_order("random", 1, shuffled, n);
+	bench_insert_order("sorted", 1, sorted, n);
+	bench_insert_order("sorted", 0, sorted, n < SORTED_PLAIN_MAX ? n : SORTED_PLAIN_MAX);
+
+	free(sorted);
+}
+
+int main(int argc, char const *argv[]) {
+
+	int n = argc > 1 ? atoi(argv[1]) : 10000000;
+	if (n < 1){
+		fprintf(stderr, "Usage: %s [keys]\n", argv[0]);
+		return 1;
+	}
+
+	int* keys = malloc(n * sizeof(int));
+	if (keys == NULL){
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	for (int i = 0; i < n; i++){
+		keys[i] = 2 * i;
+	}
+
+	// Random insert order, so nodes are scattered the way a live tree's are
+	unsigned state = 88675123u;
+	for (int i = n - 1; i > 0; i--){
+		int j = next_random(&state) % (i + 1);
+		int swap = keys[i];
+		keys[i] = keys[j];
+		keys[j] = swap;
+	}
+
+	struct bst* bst = bst_create_balanced();
+	if (bst == NULL){
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	for (int i = 0; i < n; i++){
+		bst_insert(bst, keys[i], NULL);
+	}
+
+	bench_order_statistics(bst, n);
+	bench_range_sum(bst, n);
+	bst_free(bst);
+
+	bench_insert(keys, n);
+	free(keys);
+
+	return 0;
+}
@@ -0,0 +1,424 @@
+/***********************************************************************
+** Program Filename: bst_snapshot
+** Date: 10/19/2026
+** Description: Implementation for read-only BST snapshots. A snapshot copies
+the keys of a BST into one flat array laid out for searching, either in
+Eytzinger (breadth-first) order or in van Emde Boas order, so a lookup follows
+array indices instead of node pointers. Values, keys in sorted order and
+prefix sums of the keys sit in separate arrays indexed by rank, so range
+queries are a search for each bound followed by a sequential scan.
+** Input: None
+** Output: None
+*********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "bst_snapshot.h"
+
+// Deepest vEB tree supported, enough for any int-sized snapshot
+#define BST_SNAPSHOT_MAX_LEVELS 32
+
+/*
+ * This is the structure that represents a snapshot.
+ *
+ * For BST_SNAPSHOT_EYTZINGER, tree_keys[1..n] holds the implicit tree whose
+ * node k has children 2k and 2k + 1 (slot 0 is unused).  For BST_SNAPSHOT_VEB
+ * the same kind of tree is padded to a complete tree of `levels` levels and
+ * stored recursively: the top half of the levels first, then each bottom
+ * subtree in turn, so any subtree of height h spans about h / log2(B) cache
+ * lines whatever the line size B.  The veb_* tables (one entry per depth) let
+ * a search find the next slot without recursion.
+ *
+ * tree_ranks gives the sorted position of each slot; padding slots hold
+ * INT_MAX with ranks >= n, which searches treat as "past the end".
+ */
+struct bst_snapshot{
+    int layout;
+    int n; // Number of keys
+    int levels; // Height of the vEB tree
+    int* tree_keys; // Search keys in layout order, 64-byte aligned
+    int* tree_ranks; // Sorted position of each slot
+    int* keys; // Keys in sorted order
+    void** values; // Values in sorted order
+    long long* prefix; // prefix[i] is the sum of keys[0 .. i-1]
+    int veb_top[BST_SNAPSHOT_MAX_LEVELS]; // Size of the top tree above a depth
+    int veb_bottom[BST_SNAPSHOT_MAX_LEVELS]; // Size of the bottom trees at a depth
+    int veb_root[BST_SNAPSHOT_MAX_LEVELS]; // Depth of that top tree's root
+};
+
+// Function to allocate a 64-byte aligned int array with room for `count` ints
+int* bst_snapshot_alloc_slots(size_t count){
+    // aligned_alloc wants a size that is a multiple of the alignment
+    size_t bytes = (count * sizeof(int) + 63) & ~(size_t)63;
+    return aligned_alloc(64, bytes > 0 ? bytes : 64);
+}
+
+// Function to fill slots k and below of an implicit tree with `slots` slots
+// in key order, taking sorted positions from *rank upwards
+void bst_snapshot_fill(struct bst_snapshot* snap, int* tree_keys, int* tree_ranks, size_t k, size_t slots, int* rank){
+
+    if (k > slots){
+        return;
+    }
+
+    // In-order walk, so ranks come out sorted
+    bst_snapshot_fill(snap, tree_keys, tree_ranks, 2 * k, slots, rank);
+
+    tree_keys[k] = *rank < snap->n ? snap->keys[*rank] : INT_MAX;
+    tree_ranks[k] = *rank;
+    (*rank)++;
+
+    bst_snapshot_fill(snap, tree_keys, tree_ranks, 2 * k + 1, slots, rank);
+}
+
+// Function to record how a vEB subtree of `height` levels rooted at `depth`
+// is split, recursively
+void bst_snapshot_veb_split(struct bst_snapshot* snap, int depth, int height){
+
+    if (height <= 1){
+        return;
+    }
+
+    // Top gets the lower half of the levels, bottoms the rest
+    int top = height / 2;
+    int bottom = height - top;
+
+    snap->veb_top[depth + top] = (1 << top) - 1;
+    snap->veb_bottom[depth + top] = (1 << bottom) - 1;
+    snap->veb_root[depth + top] = depth;
+
+    bst_snapshot_veb_split(snap, depth, top);
+    bst_snapshot_veb_split(snap, depth + top, bottom);
+}
+
+// Function to copy the BFS subtree rooted at `k` with `height` levels into
+// vEB order starting at *pos, using the same split as bst_snapshot_veb_split
+void bst_snapshot_veb_layout(struct bst_snapshot* snap, int* bfs_keys, int* bfs_ranks, size_t k, int height, size_t* pos){
+
+    if (height == 1){
+        snap->tree_keys[*pos] = bfs_keys[k];
+        snap->tree_ranks[*pos] = bfs_ranks[k];
+        (*pos)++;
+        return;
+    }
+
+    int top = height / 2;
+    int bottom = height - top;
+
+    bst_snapshot_veb_layout(snap, bfs_keys, bfs_ranks, k, top, pos);
+
+    // The bottom trees hang below the top tree's last level, left to right
+    size_t first = k << top;
+    for (size_t j = 0; j < ((size_t)1 << top); j++){
+        bst_snapshot_veb_layout(snap, bfs_keys, bfs_ranks, first + j, bottom, pos);
+    }
+}
+
+// Function to lay out the Eytzinger search array, 0 if out of memory
+int bst_snapshot_build_eytzinger(struct bst_snapshot* snap){
+
+    snap->tree_keys = bst_snapshot_alloc_slots((size_t)snap->n + 1);
+    snap->tree_ranks = malloc(((size_t)snap->n + 1) * sizeof(int));
+    if (snap->tree_keys == NULL || snap->tree_ranks == NULL){
+        return 0;
+    }
+
+    int rank = 0;
+    bst_snapshot_fill(snap, snap->tree_keys, snap->tree_ranks, 1, snap->n, &rank);
+
+    return 1;
+}
+
+// Function to lay out the van Emde Boas search array, 0 if out of memory
+int bst_snapshot_build_veb(struct bst_snapshot* snap){
+
+    // Smallest complete tree that holds every key
+    snap->levels = 0;
+    while (((size_t)1 << snap->levels) - 1 < (size_t)snap->n){
+        snap->levels++;
+    }
+    size_t slots = ((size_t)1 << snap->levels) - 1;
+
+    memset(snap->veb_top, 0, sizeof(snap->veb_top));
+    memset(snap->veb_bottom, 0, sizeof(snap->veb_bottom));
+    memset(snap->veb_root, 0, sizeof(snap->veb_root));
+    bst_snapshot_veb_split(snap, 0, snap->levels);
+
+    snap->tree_keys = bst_snapshot_alloc_slots(slots);
+    snap->tree_ranks = malloc((slots > 0 ? slots : 1) * sizeof(int));
+
+    // Build in BFS order first, then permute
+    int* bfs_keys = malloc((slots + 1) * sizeof(int));
+    int* bfs_ranks = malloc((slots + 1) * sizeof(int));
+
+    if (snap->tree_keys == NULL || snap->tree_ranks == NULL || bfs_keys == NULL || bfs_ranks == NULL){
+        free(bfs_keys);
+        free(bfs_ranks);
+        return 0;
+    }
+
+    int rank = 0;
+    bst_snapshot_fill(snap, bfs_keys, bfs_ranks, 1, slots, &rank);
+
+    size_t pos = 0;
+    if (snap->levels > 0){
+        bst_snapshot_veb_layout(snap, bfs_keys, bfs_ranks, 1, snap->levels, &pos);
+    }
+
+    free(bfs_keys);
+    free(bfs_ranks);
+
+    return 1;
+}
+
+/*
+ * This function should copy a BST into a new snapshot.  The snapshot shares
+ * nothing with the tree: later inserts and removes do not change it, and it
+ * stays valid after the tree is freed (the values themselves still belong to
+ * the caller).  Building takes O(n) time.
+ *
+ * BST_SNAPSHOT_EYTZINGER stores n + 1 search slots and prefetches four
+ * levels ahead while searching, which hides most memory latency when the
+ * snapshot is larger than the cache.  BST_SNAPSHOT_VEB pads the tree to the
+ * next complete size (up to 2n slots) and needs no prefetching because each
+ * cache line it loads serves several levels of the search.
+ *
+ * Params:
+ *   bst - the BST to copy.  May not be NULL.
+ *   layout - BST_SNAPSHOT_EYTZINGER or BST_SNAPSHOT_VEB.
+ *
+ * Return:
+ *   Should return the snapshot, or NULL if memory could not be allocated or
+ *   the layout is unknown.
+ */
+struct bst_snapshot* bst_snapshot_create(struct bst* bst, int layout){
+
+    if (layout != BST_SNAPSHOT_EYTZINGER && layout != BST_SNAPSHOT_VEB){
+        return NULL;
+    }
+
+    struct bst_snapshot* snap = calloc(1, sizeof(struct bst_snapshot));
+    if (snap == NULL){
+        return NULL;
+    }
+
+    snap->layout = layout;
+    snap->n = bst_size(bst);
+
+    snap->keys = malloc(((size_t)snap->n + 1) * sizeof(int));
+    snap->values = malloc(((size_t)snap->n + 1) * sizeof(void*));
+    snap->prefix = malloc(((size_t)snap->n + 1) * sizeof(long long));
+    struct bst_iterator* iter = bst_iterator_create(bst);
+
+    if (snap->keys == NULL || snap->values == NULL || snap->prefix == NULL || iter == NULL){
+        bst_iterator_free(iter);
+        bst_snapshot_free(snap);
+        return NULL;
+    }
+
+    // Sorted keys, values and running sums by rank
+    snap->prefix[0] = 0;
+    for (int i = 0; i < snap->n && bst_iterator_has_next(iter); i++){
+        snap->keys[i] = bst_iterator_next(iter, &snap->values[i]);
+        snap->prefix[i + 1] = snap->prefix[i] + snap->keys[i];
+    }
+    bst_iterator_free(iter);
+
+    int built;
+    if (layout == BST_SNAPSHOT_EYTZINGER){
+        built = bst_snapshot_build_eytzinger(snap);
+    }
+    else{
+        built = bst_snapshot_build_veb(snap);
+    }
+
+    if (!built){
+        bst_snapshot_free(snap);
+        return NULL;
+    }
+
+    return snap;
+}
+
+/*
+ * This function should free the memory allocated to a snapshot.  It does not
+ * free the values stored in it.
+ */
+void bst_snapshot_free(struct bst_snapshot* snap){
+
+    if (snap == NULL){
+        return;
+    }
+
+    free(snap->tree_keys);
+    free(snap->tree_ranks);
+    free(snap->keys);
+    free(snap->values);
+    free(snap->prefix);
+    free(snap);
+}
+
+/*
+ * This function returns the number of keys in a snapshot.
+ */
+int bst_snapshot_size(struct bst_snapshot* snap){
+    return snap->n;
+}
+
+// Function to find the rank of the first key >= key (or > key when
+// `inclusive`) in the Eytzinger layout
+int bst_snapshot_eytzinger_bound(struct bst_snapshot* snap, int key, int inclusive){
+
+    const int* tree = snap->tree_keys;
+    size_t n = snap->n;
+    size_t k = 1;
+
+    // Branch-free descent; the 16 slots four levels down share a cache line
+    while (k <= n){
+        __builtin_prefetch(tree + 16 * k);
+        int x = tree[k];
+        k = 2 * k + ((x < key) | (inclusive & (x == key)));
+    }
+
+    // Undo the trailing right turns plus the last left turn
+    k >>= __builtin_ffsll(~k);
+
+    return k ? snap->tree_ranks[k] : snap->n;
+}
+
+// Function to find the rank of the first key >= key (or > key when
+// `inclusive`) in the vEB layout
+int bst_snapshot_veb_bound(struct bst_snapshot* snap, int key, int inclusive){
+
+    size_t pos[BST_SNAPSHOT_MAX_LEVELS];
+    size_t k = 1;
+    int rank = snap->n;
+
+    pos[0] = 0;
+
+    for (int d = 0; d < snap->levels; d++){
+        int x = snap->tree_keys[pos[d]];
+        int right = (x < key) | (inclusive & (x == key));
+
+        // Remember the last node we went left at, it is the bound so far
+        rank = right ? rank : snap->tree_ranks[pos[d]];
+        k = 2 * k + right;
+
+        // Next slot: the top tree's root, past the top tree, then skip
+        // the bottom trees to the left of this one
+        if (d + 1 < snap->levels){
+            size_t top = snap->veb_top[d + 1];
+            pos[d + 1] = pos[snap->veb_root[d + 1]] + top + (k & top) * snap->veb_bottom[d + 1];
+        }
+    }
+
+    // Padding slots rank past the end
+    return rank < snap->n ? rank : snap->n;
+}
+
+// Function to find the rank of the first key >= key (or > key when
+// `inclusive`)
+int bst_snapshot_bound(struct bst_snapshot* snap, int key, int inclusive){
+    if (snap->layout == BST_SNAPSHOT_EYTZINGER){
+        return bst_snapshot_eytzinger_bound(snap, key, inclusive);
+    }
+    return bst_snapshot_veb_bound(snap, key, inclusive);
+}
+
+/*
+ * This function should return the value associated with a key in a
+ * snapshot.  If the key was stored several times, the value of the first one
+ * in key order is returned.
+ *
+ * Params:
+ *   snap - the snapshot to search.  May not be NULL.
+ *   key - the key whose value is to be returned.
+ *
+ * Return:
+ *   Should return the value, or NULL if the key is not in the snapshot.
+ */
+void* bst_snapshot_get(struct bst_snapshot* snap, int key){
+
+    int rank = bst_snapshot_bound(snap, key, 0);
+
+    if (rank < snap->n && snap->keys[rank] == key){
+        return snap->values[rank];
+    }
+
+    return NULL;
+}
+
+/*
+ * This function should return 1 if `key` is in the snapshot and 0 if not.
+ */
+int bst_snapshot_contains(struct bst_snapshot* snap, int key){
+    int rank = bst_snapshot_bound(snap, key, 0);
+    return rank < snap->n && snap->keys[rank] == key;
+}
+
+/*
+ * This function should return the number of keys in the snapshot that are
+ * less than `key`, which does not need to be in the snapshot.
+ */
+int bst_snapshot_rank(struct bst_snapshot* snap, int key){
+    return bst_snapshot_bound(snap, key, 0);
+}
+
+/*
+ * This function should return the sum of all keys in the snapshot between
+ * `lower` and `upper` (inclusive), the same as bst_range_sum() on the tree
+ * it was taken from.  It costs two searches and a subtraction.
+ *
+ * Params:
+ *   snap - the snapshot to search.  May not be NULL.
+ *   lower - the lower bound of the range.
+ *   upper - the upper bound of the range.
+ *
+ * Return:
+ *   Should return the sum, or 0 if the range is empty.
+ */
+int bst_snapshot_range_sum(struct bst_snapshot* snap, int lower, int upper){
+
+    if (lower > upper){
+        return 0;
+    }
+
+    int lo = bst_snapshot_bound(snap, lower, 0);
+    int hi = bst_snapshot_bound(snap, upper, 1);
+
+    return (int)(snap->prefix[hi] - snap->prefix[lo]);
+}
+
+/*
+ * This function should call `visit` on every key/value pair in the snapshot
+ * with lower <= key <= upper, in key order.  After one search for the start
+ * the pairs are read sequentially from the sorted arrays.
+ *
+ * Params:
+ *   snap - the snapshot to search.  May not be NULL.
+ *   lower - the lower bound of the range.
+ *   upper - the upper bound of the range.
+ *   visit - called with each key, its value and `arg`.
+ *   arg - passed through to visit.
+ *
+ * Return:
+ *   Should return the number of pairs visited.
+ */
+int bst_snapshot_range(struct bst_snapshot* snap, int lower, int upper, void (*visit)(int key, void* value, void* arg), void* arg){
+
+    if (lower > upper){
+        return 0;
+    }
+
+    int lo = bst_snapshot_bound(snap, lower, 0);
+    int count = 0;
+
+    for (int i = lo; i < snap->n && snap->keys[i] <= upper; i++){
+        visit(snap->keys[i], snap->values[i], arg);
+        count++;
+    }
+
+    return count;
+}
@@ -0,0 +1,100 @@
+/*
+ * This file contains the definition of the interface for read-only BST
+ * snapshots.  You can find descriptions of the snapshot functions, including
+ * their parameters and their return values, in bst_snapshot.c.
+ */
+
+#ifndef __BST_SNAPSHOT_H
+#define __BST_SNAPSHOT_H
+
+#include "bst.h"
+
+// Snapshot layouts, see bst_snapshot_create()
+#define BST_SNAPSHOT_EYTZINGER 0
+#define BST_SNAPSHOT_VEB 1
+
+/*
+ * Structure used to represent a frozen, read-only copy of a BST.
+ */
+struct bst_snapshot;
+
+/*
+ * Snapshot interface function prototypes.  Refer to bst_snapshot.c for
+ * documentation about each of these functions.
+ */
+
+/*********************************************************************
+** Function: bst_snapshot_create
+** Description: Copies a BST into an immutable, pointer-free search array
+** Parameters: struct bst* bst, int layout
+** Pre-Conditions: layout is BST_SNAPSHOT_EYTZINGER or BST_SNAPSHOT_VEB
+** Post-Conditions: Returns snapshot, or NULL if allocation fails. Later changes
+to the BST do not affect it.
+*********************************************************************/
+struct bst_snapshot* bst_snapshot_create(struct bst* bst, int layout);
+
+/*********************************************************************
+** Function: bst_snapshot_free
+** Description: Frees a snapshot
+** Parameters: struct bst_snapshot* snap
+** Pre-Conditions: none
+** Post-Conditions: Snapshot is freed, stored values are not
+*********************************************************************/
+void bst_snapshot_free(struct bst_snapshot* snap);
+
+/*********************************************************************
+** Function: bst_snapshot_size
+** Description: Returns the number of keys in a snapshot
+** Parameters: struct bst_snapshot* snap
+** Pre-Conditions: Pointer to snapshot
+** Post-Conditions: Returns size
+*********************************************************************/
+int bst_snapshot_size(struct bst_snapshot* snap);
+
+/*********************************************************************
+** Function: bst_snapshot_get
+** Description: Returns the value stored for a key
+** Parameters: struct bst_snapshot* snap, int key
+** Pre-Conditions: Pointer to snapshot
+** Post-Conditions: Returns value, NULL if the key is absent
+*********************************************************************/
+void* bst_snapshot_get(struct bst_snapshot* snap, int key);
+
+/*********************************************************************
+** Function: bst_snapshot_contains
+** Description: Tests whether a key is in a snapshot
+** Parameters: struct bst_snapshot* snap, int key
+** Pre-Conditions: Pointer to snapshot
+** Post-Conditions: Returns 1 if present, 0 if not
+*********************************************************************/
+int bst_snapshot_contains(struct bst_snapshot* snap, int key);
+
+/*********************************************************************
+** Function: bst_snapshot_rank
+** Description: Returns the number of keys in a snapshot less than a given key
+** Parameters: struct bst_snapshot* snap, int key
+** Pre-Conditions: Pointer to snapshot
+** Post-Conditions: Returns rank in O(log n)
+*********************************************************************/
+int bst_snapshot_rank(struct bst_snapshot* snap, int key);
+
+/*********************************************************************
+** Function: bst_snapshot_range_sum
+** Description: Sums the keys between a lower and upper bound (inclusive)
+** Parameters: struct bst_snapshot* snap, int lower, int upper
+** Pre-Conditions: Pointer to snapshot
+** Post-Conditions: Returns sum in O(log n), same result as bst_range_sum
+*********************************************************************/
+int bst_snapshot_range_sum(struct bst_snapshot* snap, int lower, int upper);
+
+/*********************************************************************
+** Function: bst_snapshot_range
+** Description: Visits every key/value pair between two bounds (inclusive) in order
+** Parameters: struct bst_snapshot* snap, int lower, int upper,
+void (*visit)(int key, void* value, void* arg), void* arg
+** Pre-Conditions: Pointer to snapshot, visit is not NULL
+** Post-Conditions: Returns the number of pairs visited
+*********************************************************************/
+int bst_snapshot_range(struct bst_snapshot* snap, int lower, int upper, void (*visit)(int key, void* value, void* arg), void* arg);
+
+#endif
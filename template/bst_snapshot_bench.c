@@ -0,0 +1,157 @@
+/***********************************************************************
+** Program Filename: bst_snapshot_bench
+** Date: 10/19/2026
+** Description: Compares lookup latency on a pointer BST against its
+read-only snapshots in Eytzinger and van Emde Boas layout, at tree sizes
+from cache-resident to well past the last-level cache. Keys are inserted in
+random order into a balanced tree, as a live tree would have them, and at
+each size the tree is frozen in both layouts and the same random queries run
+on all three: bst_get/bst_snapshot_get on stored keys and
+bst_rank/bst_snapshot_rank on any key.
+** Input: bst_snapshot_bench [max keys], 8388608 by default; sizes grow by
+factors of 8 from 65536
+** Output: One line per size with nanoseconds per query and the time to
+create each snapshot
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "bst.h"
+#include "bst_snapshot.h"
+
+// Queries timed per structure and size
+#define QUERIES 2000000
+
+// Smallest size measured
+#define FIRST_SIZE 65536
+
+// Function to return a monotonic time in seconds
+double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Function to return the next number of a xorshift generator
+unsigned next_random(unsigned* state){
+	unsigned x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+// Function to return the nanoseconds per lookup of the given queries, on
+// the tree if snap is NULL
+double time_get(struct bst* bst, struct bst_snapshot* snap, int* queries, long long* found){
+	long long hits = 0;
+	double t = now();
+	for (int i = 0; i < QUERIES; i++){
+		hits += (snap != NULL ? bst_snapshot_get(snap, queries[i]) : bst_get(bst, queries[i])) != NULL;
+	}
+	*found = hits;
+	return (now() - t) * 1e9 / QUERIES;
+}
+
+// Function to return the nanoseconds per rank of the given queries, on the
+// tree if snap is NULL
+double time_rank(struct bst* bst, struct bst_snapshot* snap, int* queries, long long* total){
+	long long sum = 0;
+	double t = now();
+	for (int i = 0; i < QUERIES; i++){
+		sum += snap != NULL ? bst_snapshot_rank(snap, queries[i]) : bst_rank(bst, queries[i]);
+	}
+	*total = sum;
+	return (now() - t) * 1e9 / QUERIES;
+}
+
+int main(int argc, char const *argv[]) {
+
+	int max_keys = argc > 1 ? atoi(argv[1]) : 8388608;
+	if (max_keys < 1){
+		fprintf(stderr, "Usage: %s [max keys]\n", argv[0]);
+		return 1;
+	}
+
+	int* keys = malloc(max_keys * sizeof(int));
+	int* get_queries = malloc(QUERIES * sizeof(int));
+	int* rank_queries = malloc(QUERIES * sizeof(int));
+	struct bst* bst = bst_create_balanced();
+	if (keys == NULL || get_queries == NULL || rank_queries == NULL || bst == NULL){
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	// Even keys in random order; each size is a prefix of them
+	unsigned state = 2463534242u;
+	for (int i = 0; i < max_keys; i++){
+		keys[i] = 2 * i;
+	}
+	for (int i = max_keys - 1; i > 0; i--){
+		int j = next_random(&state) % (i + 1);
+		int swap = keys[i];
+		keys[i] = keys[j];
+		keys[j] = swap;
+	}
+
+	printf("nanoseconds per query, %d queries\n", QUERIES);
+	printf("%9s %9s %9s %9s %9s %9s %9s %9s %9s\n", "keys", "get tree", "get eytz", "get veb",
+		"rank tree", "rank eytz", "rank veb", "eytz ms", "veb ms");
+
+	int size = 0;
+	int next = FIRST_SIZE < max_keys ? FIRST_SIZE : max_keys;
+	while (size < max_keys){
+		for (; size < next; size++){
+			bst_insert(bst, keys[size], &keys[size]);
+		}
+
+		// Stored keys for get, any key in the range for rank
+		for (int i = 0; i < QUERIES; i++){
+			get_queries[i] = keys[next_random(&state) % (unsigned)size];
+			rank_queries[i] = (int)(next_random(&state) % (2u * max_keys));
+		}
+
+		double t = now();
+		struct bst_snapshot* eytz = bst_snapshot_create(bst, BST_SNAPSHOT_EYTZINGER);
+		double eytz_ms = (now() - t) * 1e3;
+		t = now();
+		struct bst_snapshot* veb = bst_snapshot_create(bst, BST_SNAPSHOT_VEB);
+		double veb_ms = (now() - t) * 1e3;
+		if (eytz == NULL || veb == NULL){
+			fprintf(stderr, "Out of memory\n");
+			return 1;
+		}
+
+		long long check[6];
+		double get_tree = time_get(bst, NULL, get_queries, &check[0]);
+		double get_eytz = time_get(bst, eytz, get_queries, &check[1]);
+		double get_veb = time_get(bst, veb, get_queries, &check[2]);
+		double rank_tree = time_rank(bst, NULL, rank_queries, &check[3]);
+		double rank_eytz = time_rank(bst, eytz, rank_queries, &check[4]);
+		double rank_veb = time_rank(bst, veb, rank_queries, &check[5]);
+
+		if (check[0] != QUERIES || check[1] != QUERIES || check[2] != QUERIES
+			|| check[3] != check[4] || check[3] != check[5]){
+			fprintf(stderr, "Snapshots disagree with the tree\n");
+			return 1;
+		}
+
+		printf("%9d %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n", size,
+			get_tree, get_eytz, get_veb, rank_tree, rank_eytz, rank_veb, eytz_ms, veb_ms);
+
+		bst_snapshot_free(eytz);
+		bst_snapshot_free(veb);
+
+		next = next > max_keys / 8 ? max_keys : next * 8;
+	}
+
+	bst_free(bst);
+	free(keys);
+	free(get_queries);
+	free(rank_queries);
+
+	return 0;
+}
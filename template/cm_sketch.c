@@ -0,0 +1,196 @@
+/***********************************************************************
+** Program Filename: cm_sketch
+** Date: 10/19/2026
+** Description: Implementation for a Count-Min sketch, a fixed-memory
+frequency estimator for heavy-hitter queries. Keys are hashed once with the
+hash table's ht_hash64(); the row positions are derived from that one hash.
+Counters live in one contiguous, cache-line aligned array so clearing and
+merging are straight loops the compiler vectorizes.
+** Input: None
+** Output: None
+*********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "hash_table.h"
+#include "cm_sketch.h"
+
+/*
+ * This is the structure that represents a sketch.  Row r occupies
+ * counters[r * width] through counters[r * width + width - 1].
+ */
+struct cms{
+    unsigned int* counters; // depth * width counters
+    int width; // Counters per row, a power of two
+    int depth; // Rows
+    unsigned long long total; // Sum of every count added
+};
+
+/*
+ * This function should allocate a sketch with `depth` rows of `width`
+ * counters.  Width is rounded up to a power of two so a row position is a
+ * mask instead of a division.
+ */
+struct cms* cms_create(int width, int depth){
+
+    if (width < 1 || depth < 1){
+        return NULL;
+    }
+
+    struct cms* cms = malloc(sizeof(struct cms));
+    if (cms == NULL){
+        return NULL;
+    }
+
+    // Round width up to a power of two
+    cms->width = 1;
+    while (cms->width < width){
+        cms->width *= 2;
+    }
+    cms->depth = depth;
+    cms->total = 0;
+
+    // Aligned for vector loads, size rounded to the alignment
+    size_t bytes = (size_t)cms->width * cms->depth * sizeof(unsigned int);
+    bytes = (bytes + 63) & ~(size_t)63;
+
+    cms->counters = aligned_alloc(64, bytes);
+    if (cms->counters == NULL){
+        free(cms);
+        return NULL;
+    }
+    memset(cms->counters, 0, bytes);
+
+    return cms;
+}
+
+/*
+ * This function should size a sketch from the usual error bounds: width
+ * e / epsilon and depth ln(1 / delta).
+ */
+struct cms* cms_create_error(double epsilon, double delta){
+
+    if (epsilon <= 0 || epsilon >= 1 || delta <= 0 || delta >= 1){
+        return NULL;
+    }
+
+    int width = (int)ceil(exp(1.0) / epsilon);
+    int depth = (int)ceil(log(1.0 / delta));
+
+    return cms_create(width, depth);
+}
+
+/*
+ * This function should free the memory allocated to a given sketch.
+ */
+void cms_free(struct cms* cms){
+    if (cms == NULL){
+        return;
+    }
+    free(cms->counters);
+    free(cms);
+}
+
+/*
+ * This function should reset every counter to zero.
+ */
+void cms_clear(struct cms* cms){
+    memset(cms->counters, 0, (size_t)cms->width * cms->depth * sizeof(unsigned int));
+    cms->total = 0;
+}
+
+// Function to get the position of a key in row r.  The rows use the
+// double-hashing family h1 + r * h2, which is as good as independent hashes
+// for Count-Min and needs only one call to the hasher
+unsigned int cms_position(struct cms* cms, unsigned long long hash, int r){
+    unsigned int h1 = (unsigned int)hash;
+    unsigned int h2 = (unsigned int)(hash >> 32) | 1U;
+    return (h1 + (unsigned int)r * h2) & (unsigned int)(cms->width - 1);
+}
+
+/*
+ * This function should add `count` occurrences of `key`.  Counters saturate
+ * instead of wrapping around.
+ *
+ * Params:
+ *   cms - the sketch to update.  May not be NULL.
+ *   key - the key that occurred.
+ *   convert - pointer to a function that can be passed the void* key from
+ *     to convert it to a unique integer hashcode, e.g. ht_string_hash
+ *   count - number of occurrences to add.
+ */
+void cms_add(struct cms* cms, void* key, int (*convert)(void*), unsigned int count){
+
+    unsigned long long hash = ht_hash64(key, convert);
+
+    for (int r = 0; r < cms->depth; r++){
+        unsigned int* counter = &cms->counters[(size_t)r * cms->width + cms_position(cms, hash, r)];
+        unsigned int sum = *counter + count;
+
+        // Unsigned overflow wraps to a smaller value
+        *counter = sum < *counter ? 0xffffffffU : sum;
+    }
+
+    cms->total += count;
+
+    return;
+}
+
+/*
+ * This function should return the smallest counter for `key` across all
+ * rows.  This never underestimates the true count; it overestimates by at
+ * most epsilon * cms_total() with probability 1 - delta.
+ */
+unsigned int cms_estimate(struct cms* cms, void* key, int (*convert)(void*)){
+
+    unsigned long long hash = ht_hash64(key, convert);
+    unsigned int estimate = 0xffffffffU;
+
+    for (int r = 0; r < cms->depth; r++){
+        unsigned int counter = cms->counters[(size_t)r * cms->width + cms_position(cms, hash, r)];
+        if (counter < estimate){
+            estimate = counter;
+        }
+    }
+
+    return estimate;
+}
+
+/*
+ * This function returns the sum of every count added to the sketch.
+ */
+unsigned long long cms_total(struct cms* cms){
+    return cms->total;
+}
+
+/*
+ * This function should add every counter of `src` into `dst`, so that `dst`
+ * answers queries for both streams, e.g. when combining per-thread or
+ * per-host shards.  Sketches must have the same shape and have been fed
+ * with the same convert function.
+ *
+ * Return:
+ *   Should return 1 on success and 0 if the shapes differ.
+ */
+int cms_merge(struct cms* dst, struct cms* src){
+
+    if (dst->width != src->width || dst->depth != src->depth){
+        return 0;
+    }
+
+    size_t n = (size_t)dst->width * dst->depth;
+    unsigned int* a = dst->counters;
+    const unsigned int* b = src->counters;
+
+    // Saturating add, branch-free so it vectorizes
+    for (size_t i = 0; i < n; i++){
+        unsigned int sum = a[i] + b[i];
+        a[i] = sum < a[i] ? 0xffffffffU : sum;
+    }
+
+    dst->total += src->total;
+
+    return 1;
+}
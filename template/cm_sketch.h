@@ -0,0 +1,93 @@
+/*
+ * This file contains the definition of the interface for the Count-Min
+ * sketch.  You can find descriptions of the sketch functions, including their
+ * parameters and their return values, in cm_sketch.c.
+ */
+
+#ifndef __CM_SKETCH_H
+#define __CM_SKETCH_H
+
+/*
+ * Structure used to represent a Count-Min sketch.
+ */
+struct cms;
+
+/*
+ * Count-Min sketch interface function prototypes.  Refer to cm_sketch.c for
+ * documentation about each of these functions.
+ */
+
+/*********************************************************************
+** Function: cms_create
+** Description: Allocate a zeroed sketch of depth rows by width counters
+** Parameters: int width, int depth
+** Pre-Conditions: width >= 1 (rounded up to a power of two), depth >= 1
+** Post-Conditions: Returns pointer to sketch, or NULL if allocation fails
+*********************************************************************/
+struct cms* cms_create(int width, int depth);
+
+/*********************************************************************
+** Function: cms_create_error
+** Description: Allocate a sketch sized for an error bound and confidence
+** Parameters: double epsilon, double delta
+** Pre-Conditions: 0 < epsilon < 1, 0 < delta < 1
+** Post-Conditions: Estimates exceed true counts by at most epsilon * total
+with probability 1 - delta
+*********************************************************************/
+struct cms* cms_create_error(double epsilon, double delta);
+
+/*********************************************************************
+** Function: cms_free
+** Description: Frees memory allocated to a given sketch
+** Parameters: struct cms* cms
+** Pre-Conditions: none
+** Post-Conditions: Sketch is freed
+*********************************************************************/
+void cms_free(struct cms* cms);
+
+/*********************************************************************
+** Function: cms_clear
+** Description: Resets every counter to zero
+** Parameters: struct cms* cms
+** Pre-Conditions: Pointer to sketch
+** Post-Conditions: Every estimate is 0
+*********************************************************************/
+void cms_clear(struct cms* cms);
+
+/*********************************************************************
+** Function: cms_add
+** Description: Adds count occurrences of a key
+** Parameters: struct cms* cms, void* key, int (*convert)(void*), unsigned int count
+** Pre-Conditions: Same convert is used for every call on this sketch
+** Post-Conditions: Estimate for key grows by at least count
+*********************************************************************/
+void cms_add(struct cms* cms, void* key, int (*convert)(void*), unsigned int count);
+
+/*********************************************************************
+** Function: cms_estimate
+** Description: Returns an upper estimate of how often a key was added
+** Parameters: struct cms* cms, void* key, int (*convert)(void*)
+** Pre-Conditions: Same convert as used with cms_add
+** Post-Conditions: Returns estimate, never below the true count
+*********************************************************************/
+unsigned int cms_estimate(struct cms* cms, void* key, int (*convert)(void*));
+
+/*********************************************************************
+** Function: cms_total
+** Description: Returns the sum of all counts added
+** Parameters: struct cms* cms
+** Pre-Conditions: Pointer to sketch
+** Post-Conditions: Returns total
+*********************************************************************/
+unsigned long long cms_total(struct cms* cms);
+
+/*********************************************************************
+** Function: cms_merge
+** Description: Adds the counters of src into dst, e.g. to combine shards
+** Parameters: struct cms* dst, struct cms* src
+** Pre-Conditions: Both sketches have the same width and depth
+** Post-Conditions: Returns 1 and dst counts both streams, 0 on mismatch
+*********************************************************************/
+int cms_merge(struct cms* dst, struct cms* src);
+
+#endif
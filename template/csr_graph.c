@@ -0,0 +1,926 @@
+/***********************************************************************
+** Program Filename: csr_graph
+** Date: 10/19/2026
+** Description: Implementation for a directed, weighted graph in compressed
+sparse row form. All out-edges of a node sit next to each other in two flat
+arrays, found through an offsets array, so the graph takes O(V + E) memory
+instead of O(V^2) and visiting a node's neighbors costs its degree, not V.
+The arrays are built from an edge list with a counting sort: one pass to
+count each node's edges, a prefix sum, and one pass to place them. Graphs can
+also be saved in a binary file that holds the arrays exactly as they are laid
+out in memory, so loading one is an mmap and a few header checks instead of
+parsing text. Text files can be read by several threads at once, each
+parsing a run of whole lines.
+** Input: None
+** Output: None
+*********************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "csr_graph.h"
+#include "thread_pool.h"
+
+// First bytes of a binary CSR file
+#define CSR_FILE_MAGIC "CSRGRAPH"
+
+// Format version; read with the wrong byte order it does not match
+#define CSR_FILE_VERSION 1
+
+// Sections of the file start on multiples of this
+#define CSR_FILE_ALIGN 8
+
+// Offsets written at a time when narrowing them to 32 bits
+#define CSR_FILE_CHUNK 4096
+
+// Most chunks the parallel text reader splits a file into
+#define CSR_PARSE_MAX_CHUNKS 64
+
+// Smallest chunk worth a task, in bytes; smaller files are read by one thread
+#define CSR_PARSE_MIN_CHUNK (1 << 20)
+
+// Bits of the source sorted per radix pass in a chunk
+#define CSR_PARSE_RADIX_BITS 11
+
+// The file stores 32-bit node ids and weights and 64-bit offsets, which the
+// arrays must match to be used in place
+_Static_assert(sizeof(int) == 4 && sizeof(long long) == 8, "csr_graph file format needs 32-bit int and 64-bit long long");
+
+/*
+ * Header of a binary CSR file.  It is followed by the offsets (n_nodes + 1
+ * entries of offset_bits bits), then the targets and then the weights (n_edges
+ * 32-bit entries each), every section padded to CSR_FILE_ALIGN bytes.  All
+ * values are in the byte order of the machine that wrote the file.
+ */
+struct csr_file_header{
+    char magic[8];
+    uint32_t version;
+    uint32_t offset_bits; // 32 or 64
+    int64_t n_nodes;
+    int64_t n_edges;
+};
+
+// Function to allocate a graph with room for its arrays, offsets zeroed
+struct csr_graph* csr_graph_alloc(int n_nodes, long long n_edges){
+
+    struct csr_graph* graph = malloc(sizeof(struct csr_graph));
+    if (graph == NULL){
+        return NULL;
+    }
+
+    graph->n_nodes = n_nodes;
+    graph->n_edges = n_edges;
+    graph->map = NULL;
+    graph->map_size = 0;
+    graph->offsets = calloc((size_t)n_nodes + 1, sizeof(long long));
+    graph->targets = malloc((n_edges > 0 ? (size_t)n_edges : 1) * sizeof(int));
+    graph->weights = malloc((n_edges > 0 ? (size_t)n_edges : 1) * sizeof(int));
+
+    if (graph->offsets == NULL || graph->targets == NULL || graph->weights == NULL){
+        csr_graph_free(graph);
+        return NULL;
+    }
+
+    return graph;
+}
+
+/*
+ * This function should build a graph with `n_nodes` nodes from an edge list
+ * of `n_edges` edges, edge i going from sources[i] to targets[i] with
+ * weight weights[i].  Each node's out-edges keep their order in the list,
+ * and parallel edges and self-loops are kept.
+ *
+ * Params:
+ *   n_nodes - the number of nodes, numbered from 0.
+ *   n_edges - the number of edges.
+ *   sources, targets - the endpoints of each edge.
+ *   weights - the weight of each edge, or NULL to give every edge weight 1.
+ *
+ * Return:
+ *   Should return the graph, or NULL if an endpoint is out of range or
+ *   memory could not be allocated.
+ */
+struct csr_graph* csr_graph_create(int n_nodes, long long n_edges, int* sources, int* targets, int* weights){
+
+    if (n_nodes < 0 || n_edges < 0){
+        return NULL;
+    }
+
+    struct csr_graph* graph = csr_graph_alloc(n_nodes, n_edges);
+    if (graph == NULL){
+        return NULL;
+    }
+
+    // Count out-edges, shifted by one so the prefix sum gives start offsets
+    for (long long i = 0; i < n_edges; i++){
+        if (sources[i] < 0 || sources[i] >= n_nodes || targets[i] < 0 || targets[i] >= n_nodes){
+            csr_graph_free(graph);
+            return NULL;
+        }
+        graph->offsets[sources[i] + 1]++;
+    }
+
+    for (int u = 0; u < n_nodes; u++){
+        graph->offsets[u + 1] += graph->offsets[u];
+    }
+
+    // Place each edge at its node's next free slot, which moves offsets[u]
+    // to the end of u's run
+    for (long long i = 0; i < n_edges; i++){
+        long long e = graph->offsets[sources[i]]++;
+        graph->targets[e] = targets[i];
+        graph->weights[e] = weights != NULL ? weights[i] : 1;
+    }
+
+    // Shift back: the start of u's run is the end of u - 1's
+    for (int u = n_nodes; u > 0; u--){
+        graph->offsets[u] = graph->offsets[u - 1];
+    }
+    graph->offsets[0] = 0;
+
+    return graph;
+}
+
+/*
+ * This function should read a graph in the text format of `airports.dat`:
+ * the number of nodes and the number of edges, then one "from to weight"
+ * triple per edge, separated by any whitespace.
+ *
+ * Params:
+ *   file - the file to read from.  May not be NULL.
+ *
+ * Return:
+ *   Should return the graph, or NULL if the input is malformed or memory
+ *   could not be allocated.
+ */
+struct csr_graph* csr_graph_read(FILE* file){
+
+    int n_nodes;
+    long long n_edges;
+    if (fscanf(file, " %d %lld", &n_nodes, &n_edges) != 2 || n_nodes < 0 || n_edges < 0){
+        return NULL;
+    }
+
+    size_t room = n_edges > 0 ? (size_t)n_edges : 1;
+    int* sources = malloc(room * sizeof(int));
+    int* targets = malloc(room * sizeof(int));
+    int* weights = malloc(room * sizeof(int));
+
+    struct csr_graph* graph = NULL;
+
+    if (sources != NULL && targets != NULL && weights != NULL){
+        long long i = 0;
+        while (i < n_edges && fscanf(file, " %d %d %d", &sources[i], &targets[i], &weights[i]) == 3){
+            i++;
+        }
+
+        // Missing edges mean a truncated file
+        if (i == n_edges){
+            graph = csr_graph_create(n_nodes, n_edges, sources, targets, weights);
+        }
+    }
+
+    free(sources);
+    free(targets);
+    free(weights);
+
+    return graph;
+}
+
+// Function to skip spaces, tabs and line breaks
+const char* csr_parse_space(const char* p, const char* end){
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\t' || *p == '\r')){
+        p++;
+    }
+    return p;
+}
+
+// Function to parse one number of the header line into *out; returns the
+// position after it, or NULL if there is no number or it is too long
+const char* csr_parse_number(const char* p, const char* end, long long* out){
+
+    int negative = p < end && *p == '-';
+    if (negative){
+        p++;
+    }
+
+    // Digits are found with one unsigned compare each, and capped at 18 so
+    // the value cannot overflow; callers check its range
+    const char* start = p;
+    long long value = 0;
+    while (p < end && (unsigned)(*p - '0') < 10 && p - start < 18){
+        value = value * 10 + (*p - '0');
+        p++;
+    }
+
+    if (p == start || (p < end && (unsigned)(*p - '0') < 10)){
+        return NULL;
+    }
+
+    *out = negative ? -value : value;
+    return p;
+}
+
+/*
+ * One parsed edge.  Chunks keep their edges packed so that sorting them
+ * moves one record instead of three array entries.
+ */
+struct csr_parse_edge{
+    int source;
+    int target;
+    int weight;
+};
+
+/*
+ * The share of the parallel reader done by one task: a run of whole lines of
+ * the file and the edges parsed from them, sorted by source.  Each distinct
+ * source the chunk saw gets one run, so the bookkeeping is bounded by the
+ * chunk's edges rather than by the number of nodes.  The node range
+ * [lo, hi) is this task's share of the offsets passes.
+ */
+struct csr_parse_chunk{
+    const char* begin;
+    const char* end;
+    int n_nodes;
+    long long n_edges;
+    long long capacity;
+    struct csr_parse_edge* edges;
+    long long n_runs;
+    int* run_nodes; // Source of each run, ascending
+    long long* run_slots; // Edges in each run, then the run's first slot in the graph
+    int error;
+    int lo;
+    int hi;
+    struct csr_parse_chunk* chunks; // Every chunk, for the offsets passes
+    int n_chunks;
+    struct csr_graph* graph;
+};
+
+// Function to double the room for edges in a chunk
+int csr_parse_grow(struct csr_parse_chunk* chunk){
+
+    size_t capacity = 2 * chunk->capacity;
+
+    struct csr_parse_edge* edges = realloc(chunk->edges, capacity * sizeof(struct csr_parse_edge));
+    if (edges == NULL){
+        return 0;
+    }
+
+    chunk->edges = edges;
+    chunk->capacity = capacity;
+    return 1;
+}
+
+// Function to stably sort a chunk's edges by source with an LSD radix sort,
+// skipping digits every edge shares; already sorted input costs one pass
+int csr_parse_sort(struct csr_parse_chunk* chunk){
+
+    struct csr_parse_edge* edges = chunk->edges;
+    long long n = chunk->n_edges;
+
+    long long i = 1;
+    while (i < n && edges[i - 1].source <= edges[i].source){
+        i++;
+    }
+    if (i >= n){
+        return 1;
+    }
+
+    struct csr_parse_edge* other = malloc(n * sizeof(struct csr_parse_edge));
+    if (other == NULL){
+        return 0;
+    }
+
+    long long counts[1 << CSR_PARSE_RADIX_BITS];
+    int mask = (1 << CSR_PARSE_RADIX_BITS) - 1;
+
+    for (int shift = 0; shift < 31 && ((chunk->n_nodes - 1) >> shift) != 0; shift += CSR_PARSE_RADIX_BITS){
+        memset(counts, 0, sizeof(counts));
+        for (i = 0; i < n; i++){
+            counts[(edges[i].source >> shift) & mask]++;
+        }
+
+        // Every edge has the same digit, nothing would move
+        if (counts[(edges[0].source >> shift) & mask] == n){
+            continue;
+        }
+
+        long long start = 0;
+        for (int d = 0; d <= mask; d++){
+            long long count = counts[d];
+            counts[d] = start;
+            start += count;
+        }
+
+        for (i = 0; i < n; i++){
+            other[counts[(edges[i].source >> shift) & mask]++] = edges[i];
+        }
+
+        struct csr_parse_edge* swap = edges;
+        edges = other;
+        other = swap;
+    }
+
+    free(other);
+    chunk->edges = edges;
+
+    return 1;
+}
+
+// Function to record one run per distinct source of a sorted chunk
+int csr_parse_runs(struct csr_parse_chunk* chunk){
+
+    struct csr_parse_edge* edges = chunk->edges;
+    long long n = chunk->n_edges;
+
+    long long n_runs = 0;
+    for (long long i = 0; i < n; i++){
+        if (i == 0 || edges[i].source != edges[i - 1].source){
+            n_runs++;
+        }
+    }
+
+    chunk->run_nodes = malloc((n_runs > 0 ? n_runs : 1) * sizeof(int));
+    chunk->run_slots = malloc((n_runs > 0 ? n_runs : 1) * sizeof(long long));
+    if (chunk->run_nodes == NULL || chunk->run_slots == NULL){
+        return 0;
+    }
+
+    long long r = -1;
+    for (long long i = 0; i < n; i++){
+        if (i == 0 || edges[i].source != edges[i - 1].source){
+            r++;
+            chunk->run_nodes[r] = edges[i].source;
+            chunk->run_slots[r] = 0;
+        }
+        chunk->run_slots[r]++;
+    }
+    chunk->n_runs = n_runs;
+
+    return 1;
+}
+
+// Function to parse a chunk's "from to weight" lines and sort them into runs
+void csr_parse_chunk_edges(void* arg){
+
+    struct csr_parse_chunk* chunk = arg;
+    const char* p = chunk->begin;
+    const char* end = chunk->end;
+    int n_nodes = chunk->n_nodes;
+
+    // About one edge per 6 bytes at the shortest, "0 1 2\n"; start lower
+    // and grow, text with long ids would otherwise reserve far too much
+    chunk->capacity = (end - p) / 16 + 16;
+    chunk->edges = malloc(chunk->capacity * sizeof(struct csr_parse_edge));
+
+    if (chunk->edges == NULL){
+        chunk->error = 1;
+        return;
+    }
+
+    /*
+     * One pass over the bytes with no calls: digits are found with a single
+     * unsigned compare and folded into `value`, and a number ends at the
+     * first separator after it.  Every third number completes an edge.  The
+     * end of the chunk reads as one more newline so a last line without one
+     * still ends its number.
+     */
+    long long fields[3];
+    int field = 0;
+    long long value = 0;
+    int digits = 0;
+    int negative = 0;
+
+    for (; p <= end; p++){
+        char c = p < end ? *p : '\n';
+        unsigned digit = (unsigned)(c - '0');
+
+        if (digit < 10){
+            value = value * 10 + digit;
+
+            // 18 digits cannot overflow, and no valid field is that long
+            if (++digits > 18){
+                chunk->error = 1;
+                return;
+            }
+            continue;
+        }
+
+        if (c == '-' && digits == 0 && !negative){
+            negative = 1;
+            continue;
+        }
+
+        if ((c != ' ' && c != '\n' && c != '\t' && c != '\r') || (negative && digits == 0)){
+            chunk->error = 1;
+            return;
+        }
+
+        if (digits == 0){
+            continue;
+        }
+
+        fields[field++] = negative ? -value : value;
+        value = 0;
+        digits = 0;
+        negative = 0;
+
+        if (field < 3){
+            continue;
+        }
+        field = 0;
+
+        long long source = fields[0];
+        long long target = fields[1];
+        long long weight = fields[2];
+
+        if (source < 0 || source >= n_nodes || target < 0 || target >= n_nodes || weight < INT_MIN || weight > INT_MAX){
+            chunk->error = 1;
+            return;
+        }
+
+        if (chunk->n_edges == chunk->capacity && !csr_parse_grow(chunk)){
+            chunk->error = 1;
+            return;
+        }
+
+        struct csr_parse_edge* edge = &chunk->edges[chunk->n_edges++];
+        edge->source = (int)source;
+        edge->target = (int)target;
+        edge->weight = (int)weight;
+    }
+
+    // A triple cut short by the end of the chunk
+    if (field != 0 || !csr_parse_sort(chunk) || !csr_parse_runs(chunk)){
+        chunk->error = 1;
+    }
+}
+
+// Function to find a chunk's first run whose source is >= node
+long long csr_parse_first_run(struct csr_parse_chunk* chunk, int node){
+
+    long long lo = 0;
+    long long hi = chunk->n_runs;
+    while (lo < hi){
+        long long mid = lo + (hi - lo) / 2;
+        if (chunk->run_nodes[mid] < node){
+            lo = mid + 1;
+        }
+        else{
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Function to add up the degrees of nodes [lo, hi) from every chunk's runs,
+// leaving node u's in offsets[u + 1]
+void csr_parse_chunk_degrees(void* arg){
+
+    struct csr_parse_chunk* range = arg;
+    long long* offsets = range->graph->offsets;
+
+    for (int c = 0; c < range->n_chunks; c++){
+        struct csr_parse_chunk* chunk = &range->chunks[c];
+        for (long long r = csr_parse_first_run(chunk, range->lo); r < chunk->n_runs && chunk->run_nodes[r] < range->hi; r++){
+            offsets[chunk->run_nodes[r] + 1] += chunk->run_slots[r];
+        }
+    }
+}
+
+// Function to give every run of nodes [lo, hi) its first slot, chunk by
+// chunk so each node's edges stay in file order; offsets[u] is used as u's
+// next free slot and ends at the start of u + 1
+void csr_parse_chunk_slots(void* arg){
+
+    struct csr_parse_chunk* range = arg;
+    long long* offsets = range->graph->offsets;
+
+    for (int c = 0; c < range->n_chunks; c++){
+        struct csr_parse_chunk* chunk = &range->chunks[c];
+        for (long long r = csr_parse_first_run(chunk, range->lo); r < chunk->n_runs && chunk->run_nodes[r] < range->hi; r++){
+            long long count = chunk->run_slots[r];
+            chunk->run_slots[r] = offsets[chunk->run_nodes[r]];
+            offsets[chunk->run_nodes[r]] += count;
+        }
+    }
+}
+
+// Function to copy a chunk's runs into the graph, each one contiguous
+void csr_parse_chunk_scatter(void* arg){
+
+    struct csr_parse_chunk* chunk = arg;
+    struct csr_graph* graph = chunk->graph;
+    struct csr_parse_edge* edges = chunk->edges;
+
+    long long i = 0;
+    for (long long r = 0; r < chunk->n_runs; r++){
+        long long e = chunk->run_slots[r];
+        int source = chunk->run_nodes[r];
+        for (; i < chunk->n_edges && edges[i].source == source; i++, e++){
+            graph->targets[e] = edges[i].target;
+            graph->weights[e] = edges[i].weight;
+        }
+    }
+}
+
+// Function to run fn on every chunk, on the pool when there is one, with the
+// calling thread taking the first chunk itself
+void csr_parse_run_all(struct thread_pool* pool, void (*fn)(void*), struct csr_parse_chunk* chunks, int n_chunks){
+
+    struct thread_pool_task* tasks[CSR_PARSE_MAX_CHUNKS];
+
+    for (int c = 1; c < n_chunks; c++){
+        tasks[c] = pool != NULL ? thread_pool_spawn(pool, fn, &chunks[c]) : NULL;
+        if (tasks[c] == NULL){
+            fn(&chunks[c]);
+        }
+    }
+
+    fn(&chunks[0]);
+
+    for (int c = 1; c < n_chunks; c++){
+        if (tasks[c] != NULL){
+            thread_pool_wait(pool, tasks[c]);
+        }
+    }
+}
+
+// Function to build the graph from the chunks' sorted runs, each pass split
+// over the chunks or over slices of the nodes
+struct csr_graph* csr_parse_build(struct thread_pool* pool, struct csr_parse_chunk* chunks, int n_chunks, int n_nodes, long long n_edges){
+
+    struct csr_graph* graph = csr_graph_alloc(n_nodes, n_edges);
+    if (graph == NULL){
+        return NULL;
+    }
+
+    for (int c = 0; c < n_chunks; c++){
+        chunks[c].lo = (int)((long long)n_nodes * c / n_chunks);
+        chunks[c].hi = (int)((long long)n_nodes * (c + 1) / n_chunks);
+        chunks[c].chunks = chunks;
+        chunks[c].n_chunks = n_chunks;
+        chunks[c].graph = graph;
+    }
+
+    // Degrees, then start offsets; one add per node, small next to the edges
+    csr_parse_run_all(pool, csr_parse_chunk_degrees, chunks, n_chunks);
+    for (int u = 0; u < n_nodes; u++){
+        graph->offsets[u + 1] += graph->offsets[u];
+    }
+
+    // Slots move offsets[u] to the end of u's run, shift back afterwards
+    csr_parse_run_all(pool, csr_parse_chunk_slots, chunks, n_chunks);
+    for (int u = n_nodes; u > 0; u--){
+        graph->offsets[u] = graph->offsets[u - 1];
+    }
+    graph->offsets[0] = 0;
+
+    csr_parse_run_all(pool, csr_parse_chunk_scatter, chunks, n_chunks);
+
+    return graph;
+}
+
+/*
+ * This function should read a graph from a file in the text format of
+ * `airports.dat`, like csr_graph_read(), but faster: the file is mapped
+ * instead of read through stdio, split into chunks of whole lines that are
+ * parsed on the pool's threads with a small integer scanner.  Each chunk
+ * sorts its edges by source, and the sorted runs are merged into the graph
+ * in passes that are also split between the threads.  Memory beyond the
+ * graph is O(edges), however many threads there are.  The graph is the same one csr_graph_read() builds.
+ *
+ * Unlike csr_graph_read(), every "from to weight" triple must be on a line
+ * of its own, and the file must hold exactly n_edges of them.
+ *
+ * Params:
+ *   path - the file to read.
+ *   pool - the threads to parse on, or NULL to parse on the calling thread
+ *     only.
+ *
+ * Return:
+ *   Should return the graph, or NULL if the file cannot be opened, the input
+ *   is malformed, or memory could not be allocated.
+ */
+struct csr_graph* csr_graph_read_parallel(const char* path, struct thread_pool* pool){
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0){
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0){
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = st.st_size;
+    const char* text = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (text == MAP_FAILED){
+        return NULL;
+    }
+
+    // Every byte is read once, front to back
+    madvise((void*)text, size, MADV_SEQUENTIAL);
+
+    const char* end = text + size;
+    long long n_nodes;
+    long long n_edges;
+
+    const char* p = csr_parse_number(csr_parse_space(text, end), end, &n_nodes);
+    p = p != NULL ? csr_parse_number(csr_parse_space(p, end), end, &n_edges) : NULL;
+
+    if (p == NULL || n_nodes < 0 || n_nodes > INT_MAX || n_edges < 0){
+        munmap((void*)text, size);
+        return NULL;
+    }
+
+    // One chunk per thread, counting the caller, unless the file is small
+    int n_chunks = pool != NULL ? thread_pool_size(pool) + 1 : 1;
+    if (n_chunks > CSR_PARSE_MAX_CHUNKS){
+        n_chunks = CSR_PARSE_MAX_CHUNKS;
+    }
+    if ((size_t)(end - p) < (size_t)n_chunks * CSR_PARSE_MIN_CHUNK){
+        n_chunks = 1;
+    }
+
+    struct csr_parse_chunk chunks[CSR_PARSE_MAX_CHUNKS];
+    memset(chunks, 0, sizeof(chunks));
+
+    // Cut at even byte positions, then move each cut past the next newline
+    // so that no line is split
+    const char* cut = p;
+    for (int c = 0; c < n_chunks; c++){
+        const char* next = c + 1 < n_chunks ? p + (end - p) / n_chunks * (c + 1) : end;
+        if (next < cut){
+            next = cut;
+        }
+        while (next < end && next[-1] != '\n'){
+            next++;
+        }
+        chunks[c].begin = cut;
+        chunks[c].end = next;
+        chunks[c].n_nodes = (int)n_nodes;
+        cut = next;
+    }
+
+    csr_parse_run_all(pool, csr_parse_chunk_edges, chunks, n_chunks);
+
+    long long parsed = 0;
+    int error = 0;
+    for (int c = 0; c < n_chunks; c++){
+        parsed += chunks[c].n_edges;
+        error |= chunks[c].error;
+    }
+
+    struct csr_graph* graph = NULL;
+    if (!error && parsed == n_edges){
+        graph = csr_parse_build(pool, chunks, n_chunks, (int)n_nodes, n_edges);
+    }
+
+    for (int c = 0; c < n_chunks; c++){
+        free(chunks[c].edges);
+        free(chunks[c].run_nodes);
+        free(chunks[c].run_slots);
+    }
+    munmap((void*)text, size);
+
+    return graph;
+}
+
+// Function to round a file position up to the next section start
+size_t csr_file_align(size_t pos){
+    return (pos + CSR_FILE_ALIGN - 1) & ~(size_t)(CSR_FILE_ALIGN - 1);
+}
+
+// Function to write zero bytes up to the next section start
+int csr_file_pad(FILE* file, size_t pos){
+    static const char zeros[CSR_FILE_ALIGN];
+    size_t pad = csr_file_align(pos) - pos;
+    return fwrite(zeros, 1, pad, file) == pad;
+}
+
+// Function to write the offsets narrowed to 32 bits, a chunk at a time
+int csr_file_write_offsets32(struct csr_graph* graph, FILE* file){
+
+    uint32_t chunk[CSR_FILE_CHUNK];
+    long long n = (long long)graph->n_nodes + 1;
+
+    for (long long i = 0; i < n; i += CSR_FILE_CHUNK){
+        size_t count = n - i < CSR_FILE_CHUNK ? (size_t)(n - i) : CSR_FILE_CHUNK;
+        for (size_t k = 0; k < count; k++){
+            chunk[k] = (uint32_t)graph->offsets[i + k];
+        }
+        if (fwrite(chunk, sizeof(uint32_t), count, file) != count){
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*
+ * This function should write a graph to a binary CSR file: a header followed
+ * by the offsets, targets and weights arrays as they sit in memory, so that
+ * csr_graph_load() can map the file and use it without parsing.
+ *
+ * Params:
+ *   graph - the graph to write.  May not be NULL.
+ *   path - the file to create or overwrite.
+ *   offset_bits - 64 to store offsets as they are in memory, so loading
+ *     copies nothing, or 32 to store them in half the space, widened into a
+ *     new array on load.  32 requires fewer than 2^32 edges.
+ *
+ * Return:
+ *   Should return 1, or 0 if offset_bits is invalid or the file could not be
+ *   written.
+ */
+int csr_graph_save(struct csr_graph* graph, const char* path, int offset_bits){
+
+    if (offset_bits != 32 && offset_bits != 64){
+        return 0;
+    }
+    if (offset_bits == 32 && graph->n_edges > UINT32_MAX){
+        return 0;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL){
+        return 0;
+    }
+
+    struct csr_file_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CSR_FILE_MAGIC, sizeof(header.magic));
+    header.version = CSR_FILE_VERSION;
+    header.offset_bits = offset_bits;
+    header.n_nodes = graph->n_nodes;
+    header.n_edges = graph->n_edges;
+
+    size_t n_offsets = (size_t)graph->n_nodes + 1;
+    size_t n_edges = (size_t)graph->n_edges;
+    size_t pos = sizeof(header) + n_offsets * (offset_bits / 8);
+
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    if (ok && offset_bits == 64){
+        ok = fwrite(graph->offsets, sizeof(long long), n_offsets, file) == n_offsets;
+    }
+    else if (ok){
+        ok = csr_file_write_offsets32(graph, file);
+    }
+
+    ok = ok && csr_file_pad(file, pos);
+    pos = csr_file_align(pos) + n_edges * sizeof(int);
+    ok = ok && fwrite(graph->targets, sizeof(int), n_edges, file) == n_edges;
+    ok = ok && csr_file_pad(file, pos);
+    ok = ok && fwrite(graph->weights, sizeof(int), n_edges, file) == n_edges;
+
+    // Errors while flushing show up only here
+    if (fclose(file) != 0){
+        ok = 0;
+    }
+
+    return ok;
+}
+
+/*
+ * This function should load a binary CSR file written by csr_graph_save().
+ * The file is mapped read-only and the graph's arrays point straight into
+ * the mapping, so nothing is parsed or copied, except that 32-bit offsets
+ * are widened into a new array; pages are read from disk as they are first
+ * touched.  The header, the file size and the first and last offsets are
+ * checked, but the arrays themselves are trusted.
+ *
+ * Params:
+ *   path - the file to load.
+ *
+ * Return:
+ *   Should return the graph, or NULL if the file cannot be opened or mapped,
+ *   is not a CSR file, was written with the other byte order, or is
+ *   truncated.
+ */
+struct csr_graph* csr_graph_load(const char* path){
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0){
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct csr_file_header)){
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = st.st_size;
+    char* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping keeps the file alive on its own
+    close(fd);
+
+    if (map == MAP_FAILED){
+        return NULL;
+    }
+
+    struct csr_file_header header;
+    memcpy(&header, map, sizeof(header));
+
+    // Bound the counts by the file size first so the size math cannot wrap
+    int valid = memcmp(header.magic, CSR_FILE_MAGIC, sizeof(header.magic)) == 0
+        && header.version == CSR_FILE_VERSION
+        && (header.offset_bits == 32 || header.offset_bits == 64)
+        && header.n_nodes >= 0 && header.n_nodes <= INT_MAX && (size_t)header.n_nodes < size
+        && header.n_edges >= 0 && (size_t)header.n_edges < size;
+
+    size_t offsets_pos = sizeof(header);
+    size_t targets_pos = 0;
+    size_t weights_pos = 0;
+
+    if (valid){
+        targets_pos = csr_file_align(offsets_pos + ((size_t)header.n_nodes + 1) * (header.offset_bits / 8));
+        weights_pos = csr_file_align(targets_pos + (size_t)header.n_edges * sizeof(int));
+        valid = weights_pos + (size_t)header.n_edges * sizeof(int) == size;
+    }
+
+    struct csr_graph* graph = valid ? malloc(sizeof(struct csr_graph)) : NULL;
+    if (graph == NULL){
+        munmap(map, size);
+        return NULL;
+    }
+
+    graph->n_nodes = (int)header.n_nodes;
+    graph->n_edges = header.n_edges;
+    graph->targets = (int*)(map + targets_pos);
+    graph->weights = (int*)(map + weights_pos);
+    graph->map = map;
+    graph->map_size = size;
+
+    if (header.offset_bits == 64){
+        graph->offsets = (long long*)(map + offsets_pos);
+    }
+    else{
+        graph->offsets = malloc(((size_t)header.n_nodes + 1) * sizeof(long long));
+        if (graph->offsets != NULL){
+            uint32_t* narrow = (uint32_t*)(map + offsets_pos);
+            for (long long u = 0; u <= header.n_nodes; u++){
+                graph->offsets[u] = narrow[u];
+            }
+        }
+    }
+
+    if (graph->offsets == NULL || graph->offsets[0] != 0 || graph->offsets[graph->n_nodes] != graph->n_edges){
+        csr_graph_free(graph);
+        return NULL;
+    }
+
+    return graph;
+}
+
+// Function to check whether an array of a loaded graph lies in its mapping
+int csr_graph_in_map(struct csr_graph* graph, void* array){
+    char* start = graph->map;
+    return graph->map != NULL && (char*)array >= start && (char*)array < start + graph->map_size;
+}
+
+/*
+ * This function should free a graph and its arrays, unmapping the file of a
+ * loaded graph.
+ */
+void csr_graph_free(struct csr_graph* graph){
+
+    if (graph == NULL){
+        return;
+    }
+
+    if (!csr_graph_in_map(graph, graph->offsets)){
+        free(graph->offsets);
+    }
+
+    if (graph->map != NULL){
+        munmap(graph->map, graph->map_size);
+    }
+    else{
+        free(graph->targets);
+        free(graph->weights);
+    }
+
+    free(graph);
+}
+
+/*
+ * This function returns the number of out-edges of `node`.
+ */
+long long csr_graph_degree(struct csr_graph* graph, int node){
+    return graph->offsets[node + 1] - graph->offsets[node];
+}
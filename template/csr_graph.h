@@ -0,0 +1,102 @@
+/*
+ * This file contains the definition of the interface for a directed,
+ * weighted graph in compressed sparse row (CSR) form.  You can find
+ * descriptions of the graph functions, including their parameters and their
+ * return values, in csr_graph.c.
+ */
+
+#ifndef __CSR_GRAPH_H
+#define __CSR_GRAPH_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+struct thread_pool;
+
+/*
+ * Structure used to represent a graph.  The out-edges of node u are
+ * targets[e] with weight weights[e] for offsets[u] <= e < offsets[u + 1],
+ * so iterating them touches only real edges, in one contiguous run.  The
+ * fields are public so that hot loops can read them directly; treat them as
+ * read-only, since a graph loaded from a binary file points into a read-only
+ * mapping of it.
+ */
+struct csr_graph{
+    int n_nodes;
+    long long n_edges;
+    long long* offsets; // n_nodes + 1 entries
+    int* targets; // n_edges entries
+    int* weights; // n_edges entries
+    void* map; // Mapping of the binary file the arrays point into, or NULL
+    size_t map_size;
+};
+
+/*
+ * CSR graph interface function prototypes.  Refer to csr_graph.c for
+ * documentation about each of these functions.
+ */
+
+/*********************************************************************
+** Function: csr_graph_create
+** Description: Builds a graph from an edge list
+** Parameters: int n_nodes, long long n_edges, int* sources, int* targets, int* weights
+** Pre-Conditions: Every endpoint is in [0, n_nodes); weights may be NULL for all 1
+** Post-Conditions: Returns pointer to graph, NULL if an endpoint is out of range or allocation fails
+*********************************************************************/
+struct csr_graph* csr_graph_create(int n_nodes, long long n_edges, int* sources, int* targets, int* weights);
+
+/*********************************************************************
+** Function: csr_graph_read
+** Description: Reads "n_nodes n_edges" and then n_edges "from to weight" lines
+** Parameters: FILE* file
+** Pre-Conditions: file is open for reading
+** Post-Conditions: Returns pointer to graph, NULL if the input is malformed or allocation fails
+*********************************************************************/
+struct csr_graph* csr_graph_read(FILE* file);
+
+/*********************************************************************
+** Function: csr_graph_read_parallel
+** Description: Reads the text format of csr_graph_read from a file on several threads
+** Parameters: const char* path, struct thread_pool* pool
+** Pre-Conditions: One edge per line, exactly n_edges lines; pool may be NULL for one thread
+** Post-Conditions: Returns the graph csr_graph_read would, NULL if the input is malformed or allocation fails
+*********************************************************************/
+struct csr_graph* csr_graph_read_parallel(const char* path, struct thread_pool* pool);
+
+/*********************************************************************
+** Function: csr_graph_save
+** Description: Writes a graph to a binary CSR file that csr_graph_load maps
+** Parameters: struct csr_graph* graph, const char* path, int offset_bits
+** Pre-Conditions: offset_bits is 32 (smaller, n_edges < 2^32) or 64 (no copy on load)
+** Post-Conditions: Returns 1, 0 if the file cannot be written or offset_bits is invalid
+*********************************************************************/
+int csr_graph_save(struct csr_graph* graph, const char* path, int offset_bits);
+
+/*********************************************************************
+** Function: csr_graph_load
+** Description: Maps a binary CSR file written by csr_graph_save, without parsing
+** Parameters: const char* path
+** Pre-Conditions: The file was written on a machine of the same byte order
+** Post-Conditions: Returns pointer to graph, NULL if the file is missing or not a CSR file
+*********************************************************************/
+struct csr_graph* csr_graph_load(const char* path);
+
+/*********************************************************************
+** Function: csr_graph_free
+** Description: Frees a graph
+** Parameters: struct csr_graph* graph
+** Pre-Conditions: none
+** Post-Conditions: Graph is freed
+*********************************************************************/
+void csr_graph_free(struct csr_graph* graph);
+
+/*********************************************************************
+** Function: csr_graph_degree
+** Description: Returns the number of out-edges of a node
+** Parameters: struct csr_graph* graph, int node
+** Pre-Conditions: 0 <= node < n_nodes
+** Post-Conditions: Returns degree
+*********************************************************************/
+long long csr_graph_degree(struct csr_graph* graph, int node);
+
+#endif
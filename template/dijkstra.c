@@ -9,125 +9,70 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
-#include "pq.h"
-#include "dynarray.h"
+#include "csr_graph.h"
+#include "sssp.h"
+#include "thread_pool.h"
 
 #define DATA_FILE "airports.dat"
 #define START_NODE 0
-#define INF_COST 999
 
-struct path{ // Represet path taken
-	int node; 
-	int prev;
-	int cost;
-};
+// Cost printed for nodes the start node cannot reach
+#define INF_COST 999
 
 int main(int argc, char const *argv[]) {
+	// The graph file can be given on the command line
+	const char* path = argc > 1 ? argv[1] : DATA_FILE;
+
 	/*
-	 * Open file and read the first two int: num of nodes, num of edges
+	 * A binary CSR file from graph_convert is mapped as is; otherwise parse
+	 * the text format on every core: num of nodes, num of edges, then edges
 	 */
-	int n_nodes, n_edges;
-	FILE* file = fopen(DATA_FILE, "r");
-	// First two lines are number of nodes and number of edges
-	fscanf(file, " %d %d ", &n_nodes, &n_edges);
-	
-	/*
-	 * Write your code here to find the
-	 * least-cost paths from node 0 to all other nodes in the graph.  Make sure
-	 * to print out the least-cost paths you find at the end.
-	 *
- 	 */
-
-	// Create matrix 
-	int matrix[n_nodes][n_nodes];
-
-	for(int i = 0; i < n_nodes; i++){
-		for(int j = 0; j < n_nodes; j++){
-			matrix[i][j] = INF_COST;
-		}
-	}
+	struct csr_graph* graph = csr_graph_load(path);
 
-	// Store costs of each node edge
-	int node_i = 0, node_j = 0, cost_i_j = 0;
-
-	for (int i = 0; i < n_edges; i++){
-		fscanf(file, " %d %d %d ", &node_i, &node_j, &cost_i_j);
-		matrix[node_i][node_j] = cost_i_j;
+	if (graph == NULL){
+		struct thread_pool* pool = thread_pool_create(sysconf(_SC_NPROCESSORS_ONLN) - 1);
+		graph = csr_graph_read_parallel(path, pool);
+		thread_pool_free(pool);
 	}
 
-	// Close file for reading
-	fclose(file);
-
-	// Initialize nodes
-	struct path* paths[n_nodes];
-
-	for (int i = 0; i < n_nodes; i++){
-		// Allocate memory to each path
-		paths[i] = malloc(sizeof(struct path));
-
-		// Initialize every path
-		paths[i]->node = i;
-		paths[i]->cost = INF_COST;
-		paths[i]->prev = 0;
+	if (graph == NULL){
+		fprintf(stderr, "Could not read a graph from %s\n", path);
+		return 1;
 	}
 
-	// Initialize start node to have cost 0 and undefined previous
-	paths[START_NODE]->cost = 0; 
+	int n_nodes = graph->n_nodes;
 
-	// Create new priority queue
-	struct pq* pq = pq_create();
-
-	// Insert starting ndoe with priority 0
-	pq_insert(pq, paths[START_NODE], 0);
-
-	while(!pq_isempty(pq)){
-
-		// Store the path that has the least cost from pq
-		struct path* current_path = pq_remove_first(pq);
-
-		if (current_path->cost != INF_COST){
-
-			// Update costs and previous nodes in current path
-			paths[current_path->node]->cost = current_path->cost;
-			paths[current_path->node]->prev = current_path->prev;
-
-			// Neighboring nodes
-			for (int neighbor = 0; neighbor < n_nodes; neighbor++){
-				
-				// Store total cost it takes to get to neighboring node
-				int total_cost = matrix[current_path->node][neighbor] + current_path->cost;
-
-				// If total cost is less than current cost, insert path into pq
-				if (total_cost < paths[neighbor]->cost){
-					struct path* new_path = malloc(sizeof(struct path));
+	/*
+	 * Write your code here to find the
+	 * least-cost paths from node 0 to all other nodes in the graph.  Make sure
+	 * to print out the least-cost paths you find at the end.
+	 *
+ 	 */
 
-					new_path->node = neighbor;
-					new_path->cost = total_cost;
-					new_path->prev = current_path->node;
+	// Buffers stay with the context, so a service can call sssp_run again
+	// for every query without allocating
+	struct sssp_context* ctx = sssp_context_create(n_nodes);
 
-					pq_insert(pq, new_path, total_cost);
-				}
-			}
-		}
-		else{
-			// Can free the path indicating we already visited
-			free(current_path);
-		}
+	if (ctx == NULL || !sssp_run(ctx, graph, START_NODE)){
+		fprintf(stderr, "Out of memory\n");
+		sssp_context_free(ctx);
+		csr_graph_free(graph);
+		return 1;
 	}
 
-	// Print least cost paths
+	// Print least cost paths, unreached nodes show cost INF_COST, and they
+	// and the start node show previous node 0
     for (int i = 0; i < n_nodes; i++){
-		printf("Cost to node %d: %d -- Previous node: %d\n", i, paths[i]->cost, paths[i]->prev);
-	}
-
-	// Free paths
-	for (int i = 0; i < n_nodes; i++){
-		free(paths[i]);
+		int prev = sssp_pred(ctx, i);
+		int cost = sssp_dist(ctx, i);
+		printf("Cost to node %d: %d -- Previous node: %d\n", i, cost != SSSP_INF ? cost : INF_COST, prev >= 0 ? prev : 0);
 	}
 
-	// Free pq
-	pq_free(pq);
+	// Free context and graph
+	sssp_context_free(ctx);
+	csr_graph_free(graph);
 	 
   return 0;
-}
\ No newline at end of file
+}
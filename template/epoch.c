@@ -0,0 +1,253 @@
+/***********************************************************************
+** Program Filename: epoch
+** Date: 10/19/2026
+** Description: Implementation for epoch-based memory reclamation. Readers
+announce the global epoch in a slot while they look at shared memory, without
+taking any lock. Writers retire memory they have unlinked, tagged with the
+epoch at that moment, and it is freed only once every announced epoch is
+newer, i.e. once every reader that could have seen it has left.
+** Input: None
+** Output: None
+*********************************************************************/
+
+#include <stdlib.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#include "epoch.h"
+
+// Retired objects allowed to pile up before a reclaim is attempted
+#define EPOCH_RECLAIM_BATCH 64
+
+/*
+ * One reader slot.  0 means idle, otherwise the epoch the reader entered
+ * in.  Each slot has its own cache line so readers do not contend.
+ */
+struct epoch_slot{
+    _Atomic unsigned long epoch;
+    char pad[64 - sizeof(unsigned long)];
+};
+
+/*
+ * One piece of retired memory and the epoch it was retired in.
+ */
+struct epoch_retired{
+    void* ptr;
+    void (*free_fn)(void*);
+    unsigned long epoch;
+};
+
+/*
+ * This is the structure that represents an epoch domain.  The retired list
+ * is only touched by writers, under `lock`.
+ */
+struct epoch{
+    _Atomic unsigned long global; // Current epoch, starts at 1
+    struct epoch_slot* slots;
+    int n_slots;
+    pthread_mutex_t lock;
+    struct epoch_retired* retired;
+    int n_retired;
+    int cap_retired;
+    int limit; // Reclaim when n_retired reaches this
+};
+
+/*
+ * This function should allocate an epoch domain with `max_readers` reader
+ * slots.  More readers than that may run at once, but the extra ones spin in
+ * epoch_enter() until a slot frees up.
+ */
+struct epoch* epoch_create(int max_readers){
+
+    struct epoch* epoch = malloc(sizeof(struct epoch));
+    if (epoch == NULL){
+        return NULL;
+    }
+
+    if (max_readers < 1){
+        max_readers = 1;
+    }
+
+    epoch->slots = aligned_alloc(64, max_readers * sizeof(struct epoch_slot));
+    if (epoch->slots == NULL){
+        free(epoch);
+        return NULL;
+    }
+
+    for (int i = 0; i < max_readers; i++){
+        atomic_init(&epoch->slots[i].epoch, 0);
+    }
+
+    atomic_init(&epoch->global, 1);
+    epoch->n_slots = max_readers;
+    pthread_mutex_init(&epoch->lock, NULL);
+    epoch->retired = NULL;
+    epoch->n_retired = 0;
+    epoch->cap_retired = 0;
+    epoch->limit = EPOCH_RECLAIM_BATCH;
+
+    return epoch;
+}
+
+/*
+ * This function should free every object still waiting to be reclaimed and
+ * then the domain itself.  No reader may be inside a critical section.
+ */
+void epoch_free(struct epoch* epoch){
+
+    if (epoch == NULL){
+        return;
+    }
+
+    for (int i = 0; i < epoch->n_retired; i++){
+        epoch->retired[i].free_fn(epoch->retired[i].ptr);
+    }
+
+    free(epoch->retired);
+    free(epoch->slots);
+    pthread_mutex_destroy(&epoch->lock);
+    free(epoch);
+}
+
+/*
+ * This function should mark the calling thread as reading.  Until the
+ * matching epoch_exit(), nothing retired after this call is freed, so
+ * pointers loaded from shared structures stay valid.  It never blocks on a
+ * lock: it claims a free slot with one compare-and-swap, starting from a
+ * slot picked by the thread's id.
+ *
+ * Params:
+ *   epoch - the domain to enter.  May not be NULL.
+ *
+ * Return:
+ *   Should return the slot, which must be passed to epoch_exit().
+ */
+int epoch_enter(struct epoch* epoch){
+
+    unsigned long now = atomic_load(&epoch->global);
+
+    // Spread threads over the slots
+    unsigned long long id = (unsigned long long)(size_t)pthread_self();
+    int slot = (int)(((id * 0x9E3779B97F4A7C15ULL) >> 32) % epoch->n_slots);
+
+    while (1){
+        unsigned long idle = 0;
+        if (atomic_compare_exchange_strong(&epoch->slots[slot].epoch, &idle, now)){
+            return slot;
+        }
+        slot = slot + 1 == epoch->n_slots ? 0 : slot + 1;
+    }
+}
+
+/*
+ * This function should mark the reader in `slot` as done.
+ */
+void epoch_exit(struct epoch* epoch, int slot){
+    atomic_store(&epoch->slots[slot].epoch, 0);
+}
+
+// Function to free what no reader can see, lock must be held.  Returns the
+// number of objects left
+int epoch_reclaim_locked(struct epoch* epoch){
+
+    // New readers enter in a later epoch than anything retired so far
+    atomic_fetch_add(&epoch->global, 1);
+
+    // Oldest epoch a reader is still in
+    unsigned long oldest = ULONG_MAX;
+    for (int i = 0; i < epoch->n_slots; i++){
+        unsigned long e = atomic_load(&epoch->slots[i].epoch);
+        if (e != 0 && e < oldest){
+            oldest = e;
+        }
+    }
+
+    // Free what was retired before it, keep the rest in order
+    int kept = 0;
+    for (int i = 0; i < epoch->n_retired; i++){
+        if (epoch->retired[i].epoch < oldest){
+            epoch->retired[i].free_fn(epoch->retired[i].ptr);
+        }
+        else{
+            epoch->retired[kept++] = epoch->retired[i];
+        }
+    }
+    epoch->n_retired = kept;
+
+    // Objects held back by a slow reader should not be rescanned every call
+    epoch->limit = kept * 2 > EPOCH_RECLAIM_BATCH ? kept * 2 : EPOCH_RECLAIM_BATCH;
+
+    return kept;
+}
+
+/*
+ * This function should schedule `ptr` to be passed to `free_fn` once every
+ * reader that might have loaded it has called epoch_exit().  The caller must
+ * already have made `ptr` unreachable from shared data.  Every so often this
+ * also frees what earlier calls retired.
+ *
+ * Params:
+ *   epoch - the domain readers of `ptr` use.  May not be NULL.
+ *   ptr - the memory to retire.
+ *   free_fn - called with ptr to free it, e.g. free.
+ */
+void epoch_retire(struct epoch* epoch, void* ptr, void (*free_fn)(void*)){
+
+    pthread_mutex_lock(&epoch->lock);
+
+    // Grow the retired list
+    if (epoch->n_retired == epoch->cap_retired){
+        int cap = epoch->cap_retired ? 2 * epoch->cap_retired : EPOCH_RECLAIM_BATCH;
+        struct epoch_retired* retired = realloc(epoch->retired, cap * sizeof(struct epoch_retired));
+
+        if (retired == NULL){
+            // No room to queue it, so wait out the current readers instead
+            unsigned long retired_in = atomic_fetch_add(&epoch->global, 1);
+            for (int i = 0; i < epoch->n_slots; i++){
+                unsigned long e;
+                while ((e = atomic_load(&epoch->slots[i].epoch)) != 0 && e <= retired_in){
+                    sched_yield();
+                }
+            }
+            pthread_mutex_unlock(&epoch->lock);
+            free_fn(ptr);
+            return;
+        }
+        else{
+            epoch->retired = retired;
+            epoch->cap_retired = cap;
+        }
+    }
+
+    struct epoch_retired* entry = &epoch->retired[epoch->n_retired++];
+    entry->ptr = ptr;
+    entry->free_fn = free_fn;
+    entry->epoch = atomic_load(&epoch->global);
+
+    if (epoch->n_retired >= epoch->limit){
+        epoch_reclaim_locked(epoch);
+    }
+
+    pthread_mutex_unlock(&epoch->lock);
+}
+
+/*
+ * This function should free every retired object that no reader can still
+ * see.  Writers may call it after a burst of updates.
+ *
+ * Params:
+ *   epoch - the domain to reclaim in.  May not be NULL.
+ *
+ * Return:
+ *   Should return the number of objects still waiting on readers.
+ */
+int epoch_reclaim(struct epoch* epoch){
+
+    pthread_mutex_lock(&epoch->lock);
+    int left = epoch_reclaim_locked(epoch);
+    pthread_mutex_unlock(&epoch->lock);
+
+    return left;
+}
@@ -0,0 +1,76 @@
+/*
+ * This file contains the definition of the interface for epoch-based memory
+ * reclamation.  You can find descriptions of the epoch functions, including
+ * their parameters and their return values, in epoch.c.
+ */
+
+#ifndef __EPOCH_H
+#define __EPOCH_H
+
+/*
+ * Structure used to represent an epoch domain: a set of readers and the
+ * memory retired while they may still be looking at it.
+ */
+struct epoch;
+
+/*
+ * Epoch interface function prototypes.  Refer to epoch.c for documentation
+ * about each of these functions.
+ */
+
+/*********************************************************************
+** Function: epoch_create
+** Description: Allocate an epoch domain with room for a number of concurrent readers
+** Parameters: int max_readers
+** Pre-Conditions: max_readers > 0
+** Post-Conditions: Returns pointer to domain, or NULL if allocation fails
+*********************************************************************/
+struct epoch* epoch_create(int max_readers);
+
+/*********************************************************************
+** Function: epoch_free
+** Description: Frees everything still retired and the domain itself
+** Parameters: struct epoch* epoch
+** Pre-Conditions: No reader is inside a critical section
+** Post-Conditions: Domain is freed
+*********************************************************************/
+void epoch_free(struct epoch* epoch);
+
+/*********************************************************************
+** Function: epoch_enter
+** Description: Starts a read-side critical section without locking
+** Parameters: struct epoch* epoch
+** Pre-Conditions: Pointer to domain
+** Post-Conditions: Returns a slot to pass to epoch_exit; nothing retired from now
+on is freed until then
+*********************************************************************/
+int epoch_enter(struct epoch* epoch);
+
+/*********************************************************************
+** Function: epoch_exit
+** Description: Ends a read-side critical section
+** Parameters: struct epoch* epoch, int slot
+** Pre-Conditions: slot was returned by epoch_enter on this thread
+** Post-Conditions: Pointers read inside the section must not be used again
+*********************************************************************/
+void epoch_exit(struct epoch* epoch, int slot);
+
+/*********************************************************************
+** Function: epoch_retire
+** Description: Schedules memory to be freed once no reader can still see it
+** Parameters: struct epoch* epoch, void* ptr, void (*free_fn)(void*)
+** Pre-Conditions: ptr is no longer reachable by new readers
+** Post-Conditions: free_fn(ptr) runs after every current reader exits
+*********************************************************************/
+void epoch_retire(struct epoch* epoch, void* ptr, void (*free_fn)(void*));
+
+/*********************************************************************
+** Function: epoch_reclaim
+** Description: Frees whatever retired memory no reader can still see
+** Parameters: struct epoch* epoch
+** Pre-Conditions: Pointer to domain
+** Post-Conditions: Returns the number of objects still waiting
+*********************************************************************/
+int epoch_reclaim(struct epoch* epoch);
+
+#endif
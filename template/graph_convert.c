@@ -0,0 +1,55 @@
+/***********************************************************************
+** Program Filename: graph_convert
+** Date: 10/19/2026
+** Description: Converts a graph from the text edge-list format of
+airports.dat ("n_nodes n_edges" and then one "from to weight" line per edge)
+to the binary CSR format, which csr_graph_load maps without parsing. The
+text is parsed once here, on every core, instead of every time a program
+starts.
+** Input: graph_convert <edges.txt> <graph.csr> [32|64], the last being the
+width of the stored offsets (64 by default, loaded with no copy)
+** Output: The binary file, or a message on stderr and exit status 1
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "csr_graph.h"
+#include "thread_pool.h"
+
+int main(int argc, char const *argv[]) {
+
+	if (argc != 3 && argc != 4){
+		fprintf(stderr, "Usage: %s <edges.txt> <graph.csr> [32|64]\n", argv[0]);
+		return 1;
+	}
+
+	int offset_bits = argc == 4 ? atoi(argv[3]) : 64;
+	if (offset_bits != 32 && offset_bits != 64){
+		fprintf(stderr, "Offset width must be 32 or 64\n");
+		return 1;
+	}
+
+	// Parse on every core
+	struct thread_pool* pool = thread_pool_create(sysconf(_SC_NPROCESSORS_ONLN) - 1);
+	struct csr_graph* graph = csr_graph_read_parallel(argv[1], pool);
+	thread_pool_free(pool);
+
+	if (graph == NULL){
+		fprintf(stderr, "Could not read a graph from %s\n", argv[1]);
+		return 1;
+	}
+
+	if (!csr_graph_save(graph, argv[2], offset_bits)){
+		fprintf(stderr, "Could not write %s\n", argv[2]);
+		csr_graph_free(graph);
+		return 1;
+	}
+
+	printf("%d nodes, %lld edges written to %s\n", graph->n_nodes, graph->n_edges, argv[2]);
+
+	csr_graph_free(graph);
+
+	return 0;
+}
@@ -10,10 +10,18 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+
+#ifdef HT_STATS
+#include <stdio.h>
+#include <time.h>
+#endif
 
 #include "dynarray.h"
 #include "list.h"
+#include "bloom.h"
 #include "hash_table.h"
+#include "thread_pool.h"
 
 
 /*
@@ -22,16 +30,65 @@
  */
 struct ht{
     struct node** lists; // List of pointers
-    int size; // Buckets of hash table
+    int size; // Buckets of hash table, always a power of two
     int elems; // Elements stored in hash table, i.e. values in ht
+
+    struct node** old_lists; // Buckets still being drained by a resize, NULL otherwise
+    int old_size; // Buckets in old_lists, 0 when not resizing
+    int migrate_idx; // Next bucket of old_lists to move into lists
+
+    struct bloom* filter; // Optional negative-lookup filter, NULL when disabled
+    int filter_stale; // Removals since the filter was last built
+    struct ht_filter_stats filter_stats; // Filter hit/miss counters
+
+#ifdef HT_STATS
+    struct ht_stats stats; // Counters, derived fields are filled in by ht_stats()
+#endif
 };
 
 struct node{
     void* key; // Identifier of node
     void* val; // Value stored in node
+    unsigned int code; // Hashcode of key, kept so a resize never rehashes
     struct node* next;
 };
 
+// Buckets moved from the old table on every insert or remove while resizing
+#define HT_MIGRATE_STEP 2
+
+// Statistics hooks, HT_STAT(x) compiles to nothing without HT_STATS
+#ifdef HT_STATS
+#define HT_STAT(x) x
+#else
+#define HT_STAT(x)
+#endif
+
+#ifdef HT_STATS
+// Function to read a monotonic clock in seconds
+double ht_stats_now(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Function to record memory allocated (bytes > 0) or freed (bytes < 0)
+void ht_stats_alloc(struct ht* ht, long long bytes){
+    ht->stats.bytes += bytes;
+    if (bytes > 0){
+        ht->stats.allocs++;
+        if (ht->stats.bytes > ht->stats.peak_bytes){
+            ht->stats.peak_bytes = ht->stats.bytes;
+        }
+    }
+    return;
+}
+
+// Function to get the histogram slot for a length
+int ht_stats_slot(int length){
+    return length < HT_STATS_HIST ? length : HT_STATS_HIST - 1;
+}
+#endif
+
 /*
  * This function should allocate and initialize an empty hash table and
  * return a pointer to it.
@@ -40,16 +97,40 @@ struct ht* ht_create(){
     // Allocate memory
     struct ht* ht = malloc(sizeof(struct ht));
 
-    // Start with 20 buckets (capacity), no values
-    ht->size = 20;
+    // Start with 32 buckets (capacity), no values.  A power of two lets
+    // every bucket split into exactly two when the table doubles
+    ht->size = 32;
     ht->elems = 0;
 
-    // Create list of pointers
-    ht->lists = (struct node**)malloc(ht->size * sizeof(struct node*));
+    // Not resizing
+    ht->old_lists = NULL;
+    ht->old_size = 0;
+    ht->migrate_idx = 0;
+
+    // Create list of pointers, every bucket starts empty
+    ht->lists = (struct node**)calloc(ht->size, sizeof(struct node*));
+
+    // No filter until ht_filter_enable is called
+    ht->filter = NULL;
+    ht->filter_stale = 0;
+    memset(&ht->filter_stats, 0, sizeof(ht->filter_stats));
+
+    HT_STAT(memset(&ht->stats, 0, sizeof(ht->stats));)
+    HT_STAT(ht_stats_alloc(ht, sizeof(struct ht));)
+    HT_STAT(ht_stats_alloc(ht, ht->size * sizeof(struct node*));)
 
     return ht;
 }
 
+// Function to get the chain at bucket i counted across both tables, old
+// buckets first.  Used by walks over every element
+struct node* bucket_at(struct ht* ht, int i){
+    if (i < ht->old_size){
+        return ht->old_lists[i];
+    }
+    return ht->lists[i - ht->old_size];
+}
+
 /*
  * This function should free the memory allocated to a given hash table.
  * Note that this function SHOULD NOT free the individual elements stored in
@@ -63,9 +144,9 @@ void ht_free(struct ht* ht){
     struct node* node = NULL;
     struct node* next = NULL;
 
-    // Free individual pointers to lists
-    for(int i = 0; i < ht->size; i++){
-        node = ht->lists[i];
+    // Free individual pointers to lists, in both tables while resizing
+    for(int i = 0; i < ht->old_size + ht->size; i++){
+        node = bucket_at(ht, i);
 
         // Traverse list and free nodes
         while (node != NULL){
@@ -77,6 +158,10 @@ void ht_free(struct ht* ht){
 
     // Free ht lists
     free(ht->lists);
+    free(ht->old_lists);
+
+    // Free filter, if any
+    bloom_free(ht->filter);
 
     // Finally free ht
     free(ht);
@@ -126,13 +211,65 @@ int convert(void* key){
     return *((int*)key);
 }
 
-// Function to get hash index
-int hash(void* key, int size){
-    int index = convert(key) % size;
-    if (index < 0){
-        index += size;
+// Function to get hash index, size is a power of two so this keeps the
+// low bits of the hashcode
+int hash(unsigned int code, int size){
+    return (int)(code & (unsigned int)(size - 1));
+}
+
+/*
+ * This function is a stock `convert` for NUL-terminated string keys.  It runs
+ * 32-bit FNV-1a over every byte, so keys that compare equal under strcmp()
+ * always produce the same hashcode.
+ *
+ * Params:
+ *   key - pointer to a NUL-terminated string.  May not be NULL.
+ *
+ * Return:
+ *   Should return the hashcode of the string.
+ */
+int ht_string_hash(void* key){
+
+    const unsigned char* c = key;
+    unsigned int h = 2166136261U;
+
+    while (*c != '\0'){
+        h ^= *c++;
+        h *= 16777619U;
     }
-    return index;
+
+    return (int)h;
+}
+
+// Function to spread a 32-bit hashcode over 64 bits (MurmurHash3 finalizer)
+unsigned long long mix_code(unsigned int code){
+
+    unsigned long long h = code;
+
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+
+    return h;
+}
+
+/*
+ * This function expands the hashcode produced by `convert` into a well mixed
+ * 64-bit hash (the MurmurHash3 finalizer), suitable for structures such as
+ * Bloom filters that take several independent bit positions from one hash.
+ *
+ * Params:
+ *   key - the key to hash.
+ *   convert - pointer to a function that can be passed the void* key from
+ *     to convert it to a unique integer hashcode
+ *
+ * Return:
+ *   Should return the 64-bit hash of 'key'.
+ */
+unsigned long long ht_hash64(void* key, int (*convert)(void*)){
+    return mix_code((unsigned int)convert(key));
 }
 
 /*
@@ -155,14 +292,7 @@ int ht_hash_func(struct ht* ht, void* key, int (*convert)(void*)){
     int hash_code = convert(key); 
 
     // Index is within bounds of hash table
-    int index = hash_code % ht_size(ht);
-
-    // Reverse signs if negative
-    if (index < 0){
-        index += ht_size(ht);
-    }
-
-    return index;
+    return hash((unsigned int)hash_code, ht->size);
 }
 
 // Function to update a node, given a key and a value
@@ -175,6 +305,121 @@ void set_node(struct node* node, void* key, void* value){
   return;
 }
 
+// Function to move the next bucket of the old table into the new one
+void migrate_bucket(struct ht* ht){
+
+    struct node* node = ht->old_lists[ht->migrate_idx];
+    struct node* next = NULL;
+
+    // Emptied old buckets read as NULL, so lookups can always check them
+    ht->old_lists[ht->migrate_idx] = NULL;
+    ht->migrate_idx++;
+
+    // Relink each node at the head of its new bucket
+    while (node != NULL){
+        next = node->next;
+        int index = hash(node->code, ht->size);
+        node->next = ht->lists[index];
+        ht->lists[index] = node;
+        node = next;
+    }
+
+    // Every bucket moved, drop the old table
+    if (ht->migrate_idx == ht->old_size){
+        HT_STAT(ht_stats_alloc(ht, -(long long)(ht->old_size * sizeof(struct node*)));)
+        free(ht->old_lists);
+        ht->old_lists = NULL;
+        ht->old_size = 0;
+        ht->migrate_idx = 0;
+    }
+
+    return;
+}
+
+// Function to advance an in-progress resize by up to `buckets` buckets
+void migrate_step(struct ht* ht, int buckets){
+
+    if (ht->old_lists == NULL){
+        return;
+    }
+
+    HT_STAT(double start = ht_stats_now();)
+
+    while (ht->old_lists != NULL && buckets > 0){
+        migrate_bucket(ht);
+        buckets--;
+    }
+
+    HT_STAT(ht->stats.resize_seconds += ht_stats_now() - start;)
+
+    return;
+}
+
+// Function to start doubling the number of buckets.  Nodes move over a few
+// buckets at a time so no single insert pays for the whole table
+void start_resize(struct ht* ht){
+
+    // Finish any earlier resize first
+    migrate_step(ht, ht->old_size);
+
+    HT_STAT(double start = ht_stats_now();)
+
+    struct node** bigger = (struct node**)calloc(2 * ht->size, sizeof(struct node*));
+
+    // On allocation failure keep chaining at a higher load factor
+    if (bigger == NULL){
+        return;
+    }
+
+    HT_STAT(ht_stats_alloc(ht, 2 * ht->size * sizeof(struct node*));)
+    HT_STAT(ht->stats.resizes++;)
+    HT_STAT(ht->stats.resize_seconds += ht_stats_now() - start;)
+
+    ht->old_lists = ht->lists;
+    ht->old_size = ht->size;
+    ht->migrate_idx = 0;
+
+    ht->lists = bigger;
+    ht->size = 2 * ht->size;
+
+    return;
+}
+
+// Function to find the link pointing at the node holding key, searching the
+// old table first while resizing.  Returns NULL if the key is not stored
+struct node** find_link(struct ht* ht, void* key, unsigned int code){
+
+    struct node** link = NULL;
+    HT_STAT(int probes = 0;)
+
+    if (ht->old_lists != NULL){
+        link = &ht->old_lists[hash(code, ht->old_size)];
+        while (*link != NULL){
+            HT_STAT(probes++;)
+            // Cheap hashcode check before comparing strings
+            if ((*link)->code == code && !strcmp(key, (*link)->key)){
+                HT_STAT(ht->stats.probe_hist[ht_stats_slot(probes)]++;)
+                return link;
+            }
+            link = &(*link)->next;
+        }
+    }
+
+    link = &ht->lists[hash(code, ht->size)];
+    while (*link != NULL){
+        HT_STAT(probes++;)
+        if ((*link)->code == code && !strcmp(key, (*link)->key)){
+            HT_STAT(ht->stats.probe_hist[ht_stats_slot(probes)]++;)
+            return link;
+        }
+        link = &(*link)->next;
+    }
+
+    HT_STAT(ht->stats.probe_hist[ht_stats_slot(probes)]++;)
+
+    return NULL;
+}
+
 /*
  * This function should insert a given element into a hash table with a
  * specified key. Note that you cannot have two same keys in one hash table.
@@ -185,6 +430,8 @@ void set_node(struct node* node, void* key, void* value){
  * If using chaining, double the number of buckets when the load factor is >= 4
  * If using open addressing, double the array capacity when the load factor is >= 0.75
  * load factor = (number of elements) / (hash table capacity)
+ * Doubling is incremental: each insert or remove moves HT_MIGRATE_STEP old
+ * buckets, and lookups check both tables until the move is done.
  *
  * Params:
  *   ht - the hash table into which to insert an element.  May not be NULL.
@@ -196,24 +443,27 @@ void set_node(struct node* node, void* key, void* value){
 
 void ht_insert(struct ht* ht, void* key, void* value, int (*convert)(void*)){
     
-    // Get bucket index
-    int bucket_index = hash(key, ht->size);
+    unsigned int code = (unsigned int)convert(key);
+
+    // Move part of a pending resize along
+    migrate_step(ht, HT_MIGRATE_STEP);
 
     // Update duplicate value and return
-    struct node* curr = ht->lists[bucket_index];
-    while(curr != NULL){
-        // Compare values
-        if(!strcmp(key, curr->key)){
-            curr->val = value;
-            // Exit function after updating
-            return;
-        }
-        curr = curr->next;
+    struct node** link = find_link(ht, key, code);
+    if (link != NULL){
+        (*link)->val = value;
+        // Exit function after updating
+        return;
     }
+
+    // Get bucket index
+    int bucket_index = hash(code, ht->size);
     
     // Allocate mem to new node, initialize key and value
     struct node* new_node = malloc(sizeof(struct node));
     set_node(new_node, key, value);
+    new_node->code = code;
+    HT_STAT(ht_stats_alloc(ht, sizeof(struct node));)
 
     // If bucket index is empty, insert new node
     if(ht->lists[bucket_index] == NULL){
@@ -228,6 +478,21 @@ void ht_insert(struct ht* ht, void* key, void* value, int (*convert)(void*)){
     // Increment size by one
     ht->elems++;
 
+    // Double the buckets once the load factor reaches 4
+    if (ht->old_lists == NULL && ht->elems >= 4 * ht->size){
+        start_resize(ht);
+    }
+
+    // Keep the filter in sync, growing it once it passes its capacity
+    if (ht->filter != NULL){
+        if (ht->elems > bloom_capacity(ht->filter)){
+            ht_filter_rebuild(ht);
+        }
+        else{
+            bloom_add(ht->filter, ht_hash64(key, convert));
+        }
+    }
+
     return;
 }
 
@@ -250,16 +515,30 @@ void ht_insert(struct ht* ht, void* key, void* value, int (*convert)(void*)){
  */
 void* ht_lookup(struct ht* ht, void* key, int (*convert)(void*)){
 
-    // Get bucket index and store value into node
-    int bucket_index = hash(key, ht->size);
-    struct node* node = ht->lists[bucket_index];
-    
-    // Traverse list
-    while(node != NULL){
-        if(!strcmp(key, node->key)){
-            return node->val;
+    HT_STAT(ht->stats.lookups++;)
+
+    // A negative filter answer means the key was never inserted
+    if (ht->filter != NULL){
+        ht->filter_stats.lookups++;
+        if (!bloom_contains(ht->filter, ht_hash64(key, convert))){
+            ht->filter_stats.filtered++;
+            HT_STAT(ht->stats.misses++;)
+            return NULL;
         }
-        node = node->next;
+    }
+
+    // Traverse lists of both tables while resizing
+    struct node** link = find_link(ht, key, (unsigned int)convert(key));
+    if (link != NULL){
+        HT_STAT(ht->stats.hits++;)
+        return (*link)->val;
+    }
+
+    HT_STAT(ht->stats.misses++;)
+
+    // Filter let the key through but the chain did not have it
+    if (ht->filter != NULL){
+        ht->filter_stats.false_positives++;
     }
 
     // If cannot find node with key, return NULL
@@ -282,44 +561,442 @@ void* ht_lookup(struct ht* ht, void* key, int (*convert)(void*)){
  */
 void ht_remove(struct ht* ht, void* key, int (*convert)(void*)){
     
-    // Get bucket index
-    int bucket_index = hash(key, ht->size);
+    // Move part of a pending resize along
+    migrate_step(ht, HT_MIGRATE_STEP);
+
+    // Look for node to remove, if it is not stored there is nothing to do
+    struct node** link = find_link(ht, key, (unsigned int)convert(key));
+    if (link == NULL){
+        return;
+    }
 
-    struct node* curr = ht->lists[bucket_index];
-    struct node* prev = NULL;
+    // Point the previous node (or the bucket head) past the node, then free it
+    struct node* curr = *link;
+    *link = curr->next;
+    free(curr);
+    HT_STAT(ht_stats_alloc(ht, -(long long)sizeof(struct node));)
 
-    // If value to remove is already empty, return
-    if (curr == NULL){
+    // Decrement elements stored by 1
+    ht->elems--;
+
+    // Filter bits cannot be cleared, rebuild once stale keys reach
+    // half the live ones so the rebuild cost stays amortized O(1)
+    if (ht->filter != NULL){
+        ht->filter_stale++;
+        if (ht->filter_stale > 16 && ht->filter_stale > ht->elems / 2){
+            ht_filter_rebuild(ht);
+        }
+    }
+
+    return;
+}
+
+/*
+ * This function should put a Bloom filter in front of the hash table so that
+ * lookups for absent keys return without touching a bucket.  The filter is
+ * filled from the current contents and then maintained by ht_insert().
+ * Because Bloom filter bits cannot be cleared, ht_remove() only counts stale
+ * entries and rebuilds the filter once they reach half the stored elements.
+ * The filter is filled from the hash codes already stored in the nodes, so
+ * later inserts, lookups and removes must use the `convert` the table was
+ * filled with.
+ *
+ * Params:
+ *   ht - the hash table to filter.  May not be NULL.
+ *   expected_elems - number of elements to size the filter for; it grows
+ *     automatically past this.
+ */
+void ht_filter_enable(struct ht* ht, int expected_elems){
+
+    // Never size below what is already stored
+    if (expected_elems < ht->elems){
+        expected_elems = ht->elems;
+    }
+
+    bloom_free(ht->filter);
+    ht->filter = bloom_create(expected_elems);
+
+    // On allocation failure lookups simply run unfiltered
+    if (ht->filter == NULL){
         return;
     }
 
-    // Look for node to remove
-    while(curr != NULL){
-        if(!strcmp(key, curr->key)){
-            // If node to remove is the head of list
-            if(curr == ht->lists[bucket_index]){
+    // Fill in the existing keys, this counts as the first build
+    ht_filter_rebuild(ht);
+    ht->filter_stats.rebuilds = 0;
 
-                // Set new head to be next node
-                ht->lists[bucket_index] = curr->next;
-            }
-            // If node to remove is not head
-            else{
+    return;
+}
+
+/*
+ * This function should remove the filter from a hash table.  Lookups go
+ * straight to the buckets afterwards.
+ *
+ * Params:
+ *   ht - the hash table to unfilter.  May not be NULL.
+ */
+void ht_filter_disable(struct ht* ht){
 
-                // Set previous node to point to next node
-                prev->next = curr->next;
+    bloom_free(ht->filter);
+    ht->filter = NULL;
+    ht->filter_stale = 0;
+
+    return;
+}
+
+/*
+ * This function should rebuild the filter from the keys currently stored,
+ * clearing bits left behind by removed keys.  It is called automatically,
+ * but may also be called periodically by the owner of the table.  The new
+ * filter is sized for twice the current element count.
+ *
+ * Params:
+ *   ht - the hash table whose filter is rebuilt.  May not be NULL.
+ */
+void ht_filter_rebuild(struct ht* ht){
+
+    if (ht->filter == NULL){
+        return;
+    }
+
+    // Grow when the table has outgrown the filter, otherwise keep the size
+    if (ht->elems > bloom_capacity(ht->filter)){
+        struct bloom* bigger = bloom_create(2 * ht->elems);
+        if (bigger == NULL){
+            return;
+        }
+        bloom_free(ht->filter);
+        ht->filter = bigger;
+    }
+    else{
+        bloom_clear(ht->filter);
+    }
+
+    // Add every stored key
+    for (int i = 0; i < ht->old_size + ht->size; i++){
+        for (struct node* node = bucket_at(ht, i); node != NULL; node = node->next){
+            bloom_add(ht->filter, mix_code(node->code));
+        }
+    }
+
+    ht->filter_stale = 0;
+    ht->filter_stats.rebuilds++;
+
+    return;
+}
+
+/*
+ * This function should report how well the filter is working.  The observed
+ * false-positive rate is the fraction of misses that still walked a chain.
+ *
+ * Params:
+ *   ht - the hash table whose filter is inspected.  May not be NULL.
+ *   stats - filled in with the counters; all zero if no filter is enabled.
+ */
+void ht_filter_stats(struct ht* ht, struct ht_filter_stats* stats){
+
+    if (ht->filter == NULL){
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+
+    *stats = ht->filter_stats;
+
+    stats->fill_ratio = bloom_fill_ratio(ht->filter);
+
+    // Misses are the filtered lookups plus the ones the filter let through
+    unsigned long misses = stats->filtered + stats->false_positives;
+    stats->observed_fpr = misses ? (double)stats->false_positives / misses : 0.0;
+
+    return;
+}
+
+// Function to reverse the bits of a scan cursor
+unsigned int reverse_bits(unsigned int v){
+    v = ((v >> 1) & 0x55555555U) | ((v & 0x55555555U) << 1);
+    v = ((v >> 2) & 0x33333333U) | ((v & 0x33333333U) << 2);
+    v = ((v >> 4) & 0x0f0f0f0fU) | ((v & 0x0f0f0f0fU) << 4);
+    v = ((v >> 8) & 0x00ff00ffU) | ((v & 0x00ff00ffU) << 8);
+    return (v >> 16) | (v << 16);
+}
+
+// Function to call visit on every node of one chain
+void visit_chain(struct node* node, void (*visit)(void*, void*, void*), void* arg){
+    while (node != NULL){
+        struct node* next = node->next;
+        visit(node->key, node->val, arg);
+        node = next;
+    }
+    return;
+}
+
+/*
+ * This function should visit the elements of one bucket (and, while the table
+ * is resizing, the buckets it splits into) and return the cursor for the next
+ * call.  Start with cursor 0 and stop when 0 is returned.  The cursor counts
+ * with its bits reversed, so a bucket visited before a resize covers exactly
+ * the buckets it later splits into.  Because of this, every element stored
+ * for the whole scan is visited at least once even if the table resizes
+ * between calls; elements may be visited twice across a resize.  The table
+ * may be modified between calls, but not from inside `visit`.
+ *
+ * Params:
+ *   ht - the hash table to scan.  May not be NULL.
+ *   cursor - 0 to start a scan, otherwise the value returned by the last call
+ *   visit - function called with the key, value and `arg` of each element
+ *   arg - passed through to visit
+ *
+ * Return:
+ *   Should return the cursor to pass to the next call, or 0 when done.
+ */
+unsigned int ht_scan(struct ht* ht, unsigned int cursor, void (*visit)(void* key, void* value, void* arg), void* arg){
+
+    // Only one table, visit a bucket and step the reversed cursor
+    if (ht->old_lists == NULL){
+        unsigned int mask = (unsigned int)ht->size - 1;
+
+        visit_chain(ht->lists[cursor & mask], visit, arg);
+
+        cursor |= ~mask;
+        cursor = reverse_bits(reverse_bits(cursor) + 1);
+        return cursor;
+    }
+
+    // Resizing, the old table is the smaller one
+    unsigned int small_mask = (unsigned int)ht->old_size - 1;
+    unsigned int large_mask = (unsigned int)ht->size - 1;
+
+    visit_chain(ht->old_lists[cursor & small_mask], visit, arg);
+
+    // Visit every bucket of the larger table the small bucket splits into
+    do{
+        visit_chain(ht->lists[cursor & large_mask], visit, arg);
+
+        cursor |= ~large_mask;
+        cursor = reverse_bits(reverse_bits(cursor) + 1);
+    } while (cursor & (small_mask ^ large_mask));
+
+    return cursor;
+}
+
+// Function to copy the elements of buckets [first, last) to out, or only
+// count them if out is NULL.  Returns the number of elements
+int export_range(struct ht* ht, int first, int last, struct ht_entry* out){
+
+    int count = 0;
+
+    for (int i = first; i < last; i++){
+        for (struct node* node = bucket_at(ht, i); node != NULL; node = node->next){
+            if (out != NULL){
+                out[count].key = node->key;
+                out[count].value = node->val;
             }
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/*
+ * This function should copy every key/value pair into a contiguous array, in
+ * bucket order.  `out` must have room for ht_size(ht) entries.
+ *
+ * Params:
+ *   ht - the hash table to export.  May not be NULL.
+ *   out - array of at least ht_size(ht) entries.
+ *
+ * Return:
+ *   Should return the number of entries written, ht_size(ht).
+ */
+int ht_export(struct ht* ht, struct ht_entry* out){
+    return export_range(ht, 0, ht->old_size + ht->size, out);
+}
+
+// Work given to one export thread
+struct export_job{
+    struct ht* ht;
+    int first; // First bucket of the range
+    int last; // One past the last bucket
+    int count; // Elements in the range
+    struct ht_entry* out; // NULL while counting, then where to write
+};
+
+// Task function to count or copy one bucket range
+void export_worker(void* arg){
+    struct export_job* job = arg;
+    job->count = export_range(job->ht, job->first, job->last, job->out);
+}
 
-            // Free
-            free(curr);
+// Function to run export_worker over every job, the first on the calling
+// thread and the rest on the pool
+void run_export_jobs(struct thread_pool* pool, struct export_job* jobs, struct thread_pool_task** tasks, int n_jobs){
+
+    for (int t = 1; t < n_jobs; t++){
+        tasks[t] = thread_pool_spawn(pool, export_worker, &jobs[t]);
+
+        // If no task could be queued, do the range here
+        if (tasks[t] == NULL){
+            export_worker(&jobs[t]);
         }
+    }
 
-        // Iterate through list
-        prev = curr;
-        curr = curr->next;
+    export_worker(&jobs[0]);
+
+    for (int t = 1; t < n_jobs; t++){
+        if (tasks[t] != NULL){
+            thread_pool_wait(pool, tasks[t]);
+        }
     }
 
-    // Decrement elements stored by 1
-    ht->elems--;
+    return;
+}
+
+/*
+ * This function should do the same as ht_export(), splitting the bucket range
+ * across `n_threads` threads.  Each thread first counts its range, the counts
+ * are turned into offsets, and then each thread copies its range to its own
+ * part of `out`, so the result matches ht_export() exactly.  Both passes run
+ * on one thread pool, started once per call.  The table must not be modified
+ * while this runs.
+ *
+ * Params:
+ *   ht - the hash table to export.  May not be NULL.
+ *   out - array of at least ht_size(ht) entries.
+ *   n_threads - number of threads to use, the calling one included, capped
+ *     at the number of online CPUs; values below 2 export serially.
+ *
+ * Return:
+ *   Should return the number of entries written, ht_size(ht).
+ */
+int ht_export_parallel(struct ht* ht, struct ht_entry* out, int n_threads){
+
+    int buckets = ht->old_size + ht->size;
+
+    // More threads than cores or buckets only adds overhead
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 0 && n_threads > cpus){
+        n_threads = (int)cpus;
+    }
+    if (n_threads > buckets){
+        n_threads = buckets;
+    }
+    if (n_threads < 2){
+        return ht_export(ht, out);
+    }
+
+    struct export_job* jobs = malloc(n_threads * sizeof(struct export_job));
+    struct thread_pool_task** tasks = malloc(n_threads * sizeof(struct thread_pool_task*));
+    struct thread_pool* pool = thread_pool_create(n_threads - 1);
+    if (jobs == NULL || tasks == NULL || pool == NULL){
+        free(jobs);
+        free(tasks);
+        thread_pool_free(pool);
+        return ht_export(ht, out);
+    }
+
+    // Split buckets evenly, count each range
+    for (int t = 0; t < n_threads; t++){
+        jobs[t].ht = ht;
+        jobs[t].first = (int)((long long)buckets * t / n_threads);
+        jobs[t].last = (int)((long long)buckets * (t + 1) / n_threads);
+        jobs[t].out = NULL;
+    }
+    run_export_jobs(pool, jobs, tasks, n_threads);
+
+    // Exclusive prefix sum of the counts gives each range its offset
+    int offset = 0;
+    for (int t = 0; t < n_threads; t++){
+        jobs[t].out = out + offset;
+        offset += jobs[t].count;
+    }
+    run_export_jobs(pool, jobs, tasks, n_threads);
+
+    thread_pool_free(pool);
+    free(jobs);
+    free(tasks);
+
+    return offset;
+}
+
+#ifdef HT_STATS
+/*
+ * This function should report the table's counters along with its current
+ * shape.  The chain-length histogram is computed by walking every bucket,
+ * so it costs O(buckets + elements); the other fields are kept as the table
+ * is used.  Only available when built with HT_STATS.
+ *
+ * Params:
+ *   ht - the hash table to inspect.  May not be NULL.
+ *   stats - filled in with the statistics.
+ */
+void ht_stats(struct ht* ht, struct ht_stats* stats){
+
+    *stats = ht->stats;
+
+    stats->elems = ht->elems;
+    stats->buckets = ht->old_size + ht->size;
+    stats->load_factor = (double)ht->elems / ht->size;
+
+    // Chain lengths as they are right now
+    memset(stats->chain_hist, 0, sizeof(stats->chain_hist));
+    stats->longest_chain = 0;
+
+    for (int i = 0; i < ht->old_size + ht->size; i++){
+        int length = 0;
+        for (struct node* node = bucket_at(ht, i); node != NULL; node = node->next){
+            length++;
+        }
+
+        // Drained old buckets are not chains anymore
+        if (i < ht->old_size && i < ht->migrate_idx){
+            continue;
+        }
+
+        stats->chain_hist[ht_stats_slot(length)]++;
+        if (length > stats->longest_chain){
+            stats->longest_chain = length;
+        }
+    }
 
     return;
-} 
+}
+
+// Function to print one histogram, skipping empty slots
+void ht_stats_dump_hist(FILE* out, const char* name, const unsigned long* hist){
+    fprintf(out, "  %s:\n", name);
+    for (int i = 0; i < HT_STATS_HIST; i++){
+        if (hist[i] != 0){
+            fprintf(out, "    %2d%s %lu\n", i, i == HT_STATS_HIST - 1 ? "+" : " ", hist[i]);
+        }
+    }
+    return;
+}
+
+/*
+ * This function should print the statistics of a table in a human-readable
+ * form.  Only available when built with HT_STATS.
+ *
+ * Params:
+ *   ht - the hash table to report on.  May not be NULL.
+ *   out - stream to write to, e.g. stderr.
+ */
+void ht_stats_dump(struct ht* ht, FILE* out){
+
+    struct ht_stats stats;
+    ht_stats(ht, &stats);
+
+    double hit_ratio = stats.lookups ? (double)stats.hits / stats.lookups : 0.0;
+
+    fprintf(out, "hash table %p\n", (void*)ht);
+    fprintf(out, "  elements: %d, buckets: %d, load factor: %.2f\n", stats.elems, stats.buckets, stats.load_factor);
+    fprintf(out, "  lookups: %lu, hits: %lu, misses: %lu, hit ratio: %.3f\n", stats.lookups, stats.hits, stats.misses, hit_ratio);
+    fprintf(out, "  resizes: %lu, resize time: %.6f s\n", stats.resizes, stats.resize_seconds);
+    fprintf(out, "  bytes: %zu, peak bytes: %zu, allocations: %lu\n", stats.bytes, stats.peak_bytes, stats.allocs);
+    fprintf(out, "  longest chain: %d\n", stats.longest_chain);
+    ht_stats_dump_hist(out, "nodes compared per search", stats.probe_hist);
+    ht_stats_dump_hist(out, "chain lengths", stats.chain_hist);
+
+    return;
+}
+#endif
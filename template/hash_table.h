@@ -14,6 +14,26 @@
  */
 struct ht;
 
+/*
+ * One key/value pair, as written by ht_export().
+ */
+struct ht_entry{
+    void* key;
+    void* value;
+};
+
+/*
+ * Counters describing the optional lookup filter.  See ht_filter_stats().
+ */
+struct ht_filter_stats{
+    unsigned long lookups; // ht_lookup calls made while the filter was enabled
+    unsigned long filtered; // Misses answered by the filter alone
+    unsigned long false_positives; // Misses the filter let through to a chain
+    unsigned long rebuilds; // Times the filter was rebuilt
+    double fill_ratio; // Fraction of filter bits set
+    double observed_fpr; // false_positives / (filtered + false_positives)
+};
+
 /*
  * Hash table interface function prototypes.  Refer to hash_table.c for
  * documentation about each of these functions.
@@ -92,4 +112,138 @@ void* ht_lookup(struct ht* ht, void* key, int (*convert)(void*));
 *********************************************************************/
 void ht_remove(struct ht* ht, void* key, int (*convert)(void*));
 
+/*********************************************************************
+** Function: ht_string_hash
+** Description: Stock convert function that hashes a NUL-terminated string
+** Parameters: void* key
+** Pre-Conditions: key is a NUL-terminated string
+** Post-Conditions: Returns FNV-1a hashcode of every byte in key
+*********************************************************************/
+int ht_string_hash(void* key);
+
+/*********************************************************************
+** Function: ht_hash64
+** Description: Mixes the hashcode from convert into a 64-bit hash
+** Parameters: void* key, int (*convert)(void*)
+** Pre-Conditions: none
+** Post-Conditions: Returns 64-bit hash with well distributed bits
+*********************************************************************/
+unsigned long long ht_hash64(void* key, int (*convert)(void*));
+
+/*********************************************************************
+** Function: ht_filter_enable
+** Description: Puts a blocked Bloom filter in front of lookups
+** Parameters: struct ht* ht, int expected_elems
+** Pre-Conditions: Later insert/lookup/remove use the convert the table was filled with
+** Post-Conditions: Lookups of absent keys usually skip the buckets
+*********************************************************************/
+void ht_filter_enable(struct ht* ht, int expected_elems);
+
+/*********************************************************************
+** Function: ht_filter_disable
+** Description: Removes the lookup filter from a hash table
+** Parameters: struct ht* ht
+** Pre-Conditions: none
+** Post-Conditions: Filter is freed, lookups go straight to buckets
+*********************************************************************/
+void ht_filter_disable(struct ht* ht);
+
+/*********************************************************************
+** Function: ht_filter_rebuild
+** Description: Rebuilds the filter from stored keys, dropping removed ones
+** Parameters: struct ht* ht
+** Pre-Conditions: none
+** Post-Conditions: Filter holds exactly the current keys
+*********************************************************************/
+void ht_filter_rebuild(struct ht* ht);
+
+/*********************************************************************
+** Function: ht_filter_stats
+** Description: Reports filter counters and false-positive rate
+** Parameters: struct ht* ht, struct ht_filter_stats* stats
+** Pre-Conditions: stats is not NULL
+** Post-Conditions: stats is filled in, all zero without a filter
+*********************************************************************/
+void ht_filter_stats(struct ht* ht, struct ht_filter_stats* stats);
+
+/*********************************************************************
+** Function: ht_scan
+** Description: Visits the elements of the next bucket(s) of a scan
+** Parameters: struct ht* ht, unsigned int cursor, visit function, void* arg
+** Pre-Conditions: cursor is 0 or the value returned by the last call
+** Post-Conditions: Returns next cursor, 0 when the scan is complete
+*********************************************************************/
+unsigned int ht_scan(struct ht* ht, unsigned int cursor, void (*visit)(void* key, void* value, void* arg), void* arg);
+
+/*********************************************************************
+** Function: ht_export
+** Description: Copies every key/value pair into a contiguous array
+** Parameters: struct ht* ht, struct ht_entry* out
+** Pre-Conditions: out has room for ht_size(ht) entries
+** Post-Conditions: Returns number of entries written
+*********************************************************************/
+int ht_export(struct ht* ht, struct ht_entry* out);
+
+/*********************************************************************
+** Function: ht_export_parallel
+** Description: Same as ht_export, splitting buckets across threads (at most one per CPU)
+** Parameters: struct ht* ht, struct ht_entry* out, int n_threads
+** Pre-Conditions: out has room for ht_size(ht) entries, ht is not modified
+** Post-Conditions: Returns number of entries written, same order as ht_export
+*********************************************************************/
+int ht_export_parallel(struct ht* ht, struct ht_entry* out, int n_threads);
+
+#ifdef HT_STATS
+
+#include <stdio.h>
+
+/*
+ * Optional instrumentation, compiled in only when hash_table.c and its users
+ * are built with -DHT_STATS.  Without it none of this exists and the table
+ * carries no counters.
+ */
+
+// Histogram slots; the last slot also counts every larger length
+#define HT_STATS_HIST 16
+
+/*
+ * Table statistics.  See ht_stats().
+ */
+struct ht_stats{
+    int elems; // Elements stored
+    int buckets; // Buckets, in both tables while resizing
+    double load_factor; // elems / buckets of the current table
+    unsigned long lookups; // ht_lookup calls
+    unsigned long hits; // Lookups that found their key
+    unsigned long misses; // Lookups that did not, including filtered ones
+    unsigned long probe_hist[HT_STATS_HIST]; // Searches by nodes compared
+    unsigned long chain_hist[HT_STATS_HIST]; // Buckets by chain length
+    int longest_chain; // Longest chain right now
+    unsigned long resizes; // Times the table started doubling
+    double resize_seconds; // Time spent allocating and migrating buckets
+    size_t bytes; // Bytes currently allocated for the table and its nodes
+    size_t peak_bytes; // Largest value bytes has reached
+    unsigned long allocs; // Allocations made for the table and its nodes
+};
+
+/*********************************************************************
+** Function: ht_stats
+** Description: Reports counters and current shape of a hash table
+** Parameters: struct ht* ht, struct ht_stats* stats
+** Pre-Conditions: Built with HT_STATS, stats is not NULL
+** Post-Conditions: stats is filled in, chain histogram is computed now
+*********************************************************************/
+void ht_stats(struct ht* ht, struct ht_stats* stats);
+
+/*********************************************************************
+** Function: ht_stats_dump
+** Description: Prints the statistics of a hash table
+** Parameters: struct ht* ht, FILE* out
+** Pre-Conditions: Built with HT_STATS
+** Post-Conditions: Human-readable report is written to out
+*********************************************************************/
+void ht_stats_dump(struct ht* ht, FILE* out);
+
+#endif
+
 #endif
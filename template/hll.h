@@ -0,0 +1,75 @@
+/*
+ * This file contains the definition of the interface for the HyperLogLog
+ * distinct-count estimator.  You can find descriptions of the estimator
+ * functions, including their parameters and their return values, in hll.c.
+ */
+
+#ifndef __HLL_H
+#define __HLL_H
+
+/*
+ * Structure used to represent a HyperLogLog estimator.
+ */
+struct hll;
+
+/*
+ * HyperLogLog interface function prototypes.  Refer to hll.c for
+ * documentation about each of these functions.
+ */
+
+/*********************************************************************
+** Function: hll_create
+** Description: Allocate an empty estimator with 2^precision registers
+** Parameters: int precision
+** Pre-Conditions: 4 <= precision <= 18
+** Post-Conditions: Returns pointer to estimator, or NULL on bad precision
+or allocation failure
+*********************************************************************/
+struct hll* hll_create(int precision);
+
+/*********************************************************************
+** Function: hll_free
+** Description: Frees memory allocated to a given estimator
+** Parameters: struct hll* hll
+** Pre-Conditions: none
+** Post-Conditions: Estimator is freed
+*********************************************************************/
+void hll_free(struct hll* hll);
+
+/*********************************************************************
+** Function: hll_clear
+** Description: Resets every register
+** Parameters: struct hll* hll
+** Pre-Conditions: Pointer to estimator
+** Post-Conditions: Estimate is 0
+*********************************************************************/
+void hll_clear(struct hll* hll);
+
+/*********************************************************************
+** Function: hll_add
+** Description: Records one occurrence of a key
+** Parameters: struct hll* hll, void* key, int (*convert)(void*)
+** Pre-Conditions: Same convert is used for every call on this estimator
+** Post-Conditions: Key is counted once no matter how often it is added
+*********************************************************************/
+void hll_add(struct hll* hll, void* key, int (*convert)(void*));
+
+/*********************************************************************
+** Function: hll_estimate
+** Description: Estimates the number of distinct keys added
+** Parameters: struct hll* hll
+** Pre-Conditions: Pointer to estimator
+** Post-Conditions: Returns estimate, relative error about 1.04/sqrt(2^p)
+*********************************************************************/
+double hll_estimate(struct hll* hll);
+
+/*********************************************************************
+** Function: hll_merge
+** Description: Folds src into dst, e.g. to combine shards
+** Parameters: struct hll* dst, struct hll* src
+** Pre-Conditions: Both estimators have the same precision
+** Post-Conditions: Returns 1 and dst estimates the union, 0 on mismatch
+*********************************************************************/
+int hll_merge(struct hll* dst, struct hll* src);
+
+#endif
@@ -0,0 +1,122 @@
+/***********************************************************************
+** Program Filename: ht_filter_bench
+** Date: 10/19/2026
+** Description: Measures what the hash table's lookup filter buys on
+miss-heavy lookups. A table of string keys is looked up with mostly absent
+keys, first with no filter and then with the filter enabled, for several
+fractions of misses, and the counters of ht_filter_stats are printed with
+the timings so the observed false-positive rate can be checked as well.
+** Input: ht_filter_bench [keys] [lookups], by default 1000000 keys and
+4000000 lookups per run
+** Output: One line per miss fraction with nanoseconds per lookup with and
+without the filter, and the filter's counters
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "hash_table.h"
+
+// Room for one key string, "k" or "m" and a number
+#define KEY_SIZE 16
+
+// Function to return a monotonic time in seconds
+double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Function to return the nanoseconds per lookup of looking up every key in
+// queries, storing the number found in *found
+double time_lookups(struct ht* ht, char** queries, int n_queries, long long* found){
+	long long hits = 0;
+	double t = now();
+	for (int i = 0; i < n_queries; i++){
+		hits += ht_lookup(ht, queries[i], ht_string_hash) != NULL;
+	}
+	*found = hits;
+	return (now() - t) * 1e9 / n_queries;
+}
+
+int main(int argc, char const *argv[]) {
+
+	int n_keys = argc > 1 ? atoi(argv[1]) : 1000000;
+	int n_queries = argc > 2 ? atoi(argv[2]) : 4000000;
+
+	if (n_keys < 1 || n_queries < 1){
+		fprintf(stderr, "Usage: %s [keys] [lookups]\n", argv[0]);
+		return 1;
+	}
+
+	// Stored keys are "k<i>", absent ones "m<i>"; the table keeps pointers
+	char* present = malloc((size_t)n_keys * KEY_SIZE);
+	char* absent = malloc((size_t)n_queries * KEY_SIZE);
+	char** queries = malloc((size_t)n_queries * sizeof(char*));
+	if (present == NULL || absent == NULL || queries == NULL){
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	struct ht* ht = ht_create();
+	for (int i = 0; i < n_keys; i++){
+		snprintf(present + (size_t)i * KEY_SIZE, KEY_SIZE, "k%d", i);
+		ht_insert(ht, present + (size_t)i * KEY_SIZE, present + (size_t)i * KEY_SIZE, ht_string_hash);
+	}
+	for (int i = 0; i < n_queries; i++){
+		snprintf(absent + (size_t)i * KEY_SIZE, KEY_SIZE, "m%d", i);
+	}
+
+	int miss_percents[] = { 50, 90, 99, 100 };
+	unsigned state = 2463534242u;
+
+	printf("%d keys, %d lookups per run, nanoseconds per lookup\n", n_keys, n_queries);
+	printf("%6s %10s %10s %8s %10s %10s %10s %8s\n", "miss%", "no filter", "filter", "speedup",
+		"filtered", "false pos", "fpr", "fill");
+
+	for (int p = 0; p < (int)(sizeof(miss_percents) / sizeof(miss_percents[0])); p++){
+		// Same queries for both runs, hits drawn at random from the table
+		for (int i = 0; i < n_queries; i++){
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			if ((int)(state % 100) < miss_percents[p]){
+				queries[i] = absent + (size_t)i * KEY_SIZE;
+			}
+			else{
+				queries[i] = present + (size_t)(state / 100 % (unsigned)n_keys) * KEY_SIZE;
+			}
+		}
+
+		long long found_off, found_on;
+		ht_filter_disable(ht);
+		double off = time_lookups(ht, queries, n_queries, &found_off);
+
+		// The counters add up over runs, so only this run's share is shown
+		struct ht_filter_stats before, stats;
+		ht_filter_enable(ht, n_keys);
+		ht_filter_stats(ht, &before);
+		double on = time_lookups(ht, queries, n_queries, &found_on);
+		ht_filter_stats(ht, &stats);
+
+		unsigned long filtered = stats.filtered - before.filtered;
+		unsigned long false_positives = stats.false_positives - before.false_positives;
+		double fpr = filtered + false_positives > 0 ? (double)false_positives / (filtered + false_positives) : 0;
+
+		if (found_off != found_on){
+			fprintf(stderr, "Filter changed the result: %lld hits without, %lld with\n", found_off, found_on);
+			return 1;
+		}
+
+		printf("%6d %10.1f %10.1f %8.2f %10lu %10lu %10.5f %8.3f\n", miss_percents[p], off, on, off / on,
+			filtered, false_positives, fpr, stats.fill_ratio);
+	}
+
+	ht_free(ht);
+	free(present);
+	free(absent);
+	free(queries);
+
+	return 0;
+}
@@ -0,0 +1,342 @@
+/***********************************************************************
+** Program Filename: intern
+** Date: 10/19/2026
+** Description: Implementation for a string interning pool. Each distinct
+string is copied once into an arena and indexed by a hash table, so callers
+can compare interned strings by pointer (or by id) instead of strcmp. The pool
+is split into shards, each with its own lock, table and arena, so threads
+interning different strings rarely wait on each other.
+** Input: None
+** Output: None
+*********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "hash_table.h"
+#include "intern.h"
+
+// Number of shards, a power of two
+#define INTERN_SHARD_BITS 4
+#define INTERN_SHARDS (1 << INTERN_SHARD_BITS)
+
+// Default arena chunk size, longer strings get a chunk of their own
+#define INTERN_CHUNK_SIZE 65536
+
+/*
+ * One block of arena memory.  Strings are packed back to back in `data` and
+ * never move, so pointers into it stay valid until the pool is freed.
+ */
+struct intern_chunk{
+    struct intern_chunk* next;
+    size_t used; // Bytes of data handed out
+    size_t cap; // Bytes of data available
+    char data[];
+};
+
+/*
+ * One shard of the pool.  The hash table maps an interned string to its
+ * local id + 1 (so that no value is NULL), and `strings` maps local ids back.
+ */
+struct intern_shard{
+    pthread_mutex_t lock;
+    struct ht* table;
+    struct intern_chunk* chunks; // Newest chunk first
+    const char** strings; // Interned strings by local id
+    int count; // Strings in this shard
+    int cap; // Capacity of strings
+    struct intern_stats stats;
+};
+
+/*
+ * This is the structure that represents a pool.
+ */
+struct intern{
+    struct intern_shard shards[INTERN_SHARDS];
+};
+
+/*
+ * This function should allocate and initialize an empty pool and return a
+ * pointer to it.
+ */
+struct intern* intern_create(){
+
+    struct intern* pool = malloc(sizeof(struct intern));
+    if (pool == NULL){
+        return NULL;
+    }
+
+    for (int i = 0; i < INTERN_SHARDS; i++){
+        struct intern_shard* shard = &pool->shards[i];
+
+        pthread_mutex_init(&shard->lock, NULL);
+        shard->table = ht_create();
+        shard->chunks = NULL;
+        shard->strings = NULL;
+        shard->count = 0;
+        shard->cap = 0;
+        memset(&shard->stats, 0, sizeof(shard->stats));
+    }
+
+    return pool;
+}
+
+/*
+ * This function should free a pool along with every string stored in it.
+ * Pointers returned by the pool become invalid.
+ */
+void intern_free(struct intern* pool){
+
+    if (pool == NULL){
+        return;
+    }
+
+    for (int i = 0; i < INTERN_SHARDS; i++){
+        struct intern_shard* shard = &pool->shards[i];
+
+        // Free arena chunks
+        struct intern_chunk* chunk = shard->chunks;
+        while (chunk != NULL){
+            struct intern_chunk* next = chunk->next;
+            free(chunk);
+            chunk = next;
+        }
+
+        ht_free(shard->table);
+        free(shard->strings);
+        pthread_mutex_destroy(&shard->lock);
+    }
+
+    free(pool);
+}
+
+// Function to copy a string into a shard's arena, NULL if out of memory
+const char* intern_arena_copy(struct intern_shard* shard, const char* str, size_t len){
+
+    struct intern_chunk* chunk = shard->chunks;
+
+    // Start a new chunk if the newest one cannot fit the string
+    if (chunk == NULL || chunk->cap - chunk->used < len){
+        size_t cap = len > INTERN_CHUNK_SIZE ? len : INTERN_CHUNK_SIZE;
+
+        chunk = malloc(sizeof(struct intern_chunk) + cap);
+        if (chunk == NULL){
+            return NULL;
+        }
+        chunk->used = 0;
+        chunk->cap = cap;
+        chunk->next = shard->chunks;
+        shard->chunks = chunk;
+        shard->stats.arena_bytes += cap;
+    }
+
+    char* copy = chunk->data + chunk->used;
+    memcpy(copy, str, len);
+    chunk->used += len;
+
+    return copy;
+}
+
+// Function to pick the shard for a string from the top bits of its hash
+struct intern_shard* intern_shard_for(struct intern* pool, const char* str){
+    unsigned long long h = ht_hash64((void*)str, ht_string_hash);
+    return &pool->shards[h >> (64 - INTERN_SHARD_BITS)];
+}
+
+// Function to look up or store a string in its shard.  Returns the global
+// id, or -1 if memory ran out; the interned pointer is stored in `out`
+int intern_locked(struct intern* pool, const char* str, const char** out){
+
+    struct intern_shard* shard = intern_shard_for(pool, str);
+    int shard_idx = (int)(shard - pool->shards);
+    size_t len = strlen(str) + 1;
+    int local = -1;
+
+    pthread_mutex_lock(&shard->lock);
+
+    shard->stats.calls++;
+    shard->stats.bytes_requested += len;
+
+    // Values are local id + 1
+    void* found = ht_lookup(shard->table, (void*)str, ht_string_hash);
+
+    if (found != NULL){
+        local = (int)((size_t)found - 1);
+        *out = shard->strings[local];
+    }
+    else{
+        // Make room in the id array
+        if (shard->count == shard->cap){
+            int cap = shard->cap ? 2 * shard->cap : 64;
+            const char** strings = realloc(shard->strings, cap * sizeof(const char*));
+            if (strings == NULL){
+                pthread_mutex_unlock(&shard->lock);
+                *out = NULL;
+                return -1;
+            }
+            shard->strings = strings;
+            shard->cap = cap;
+        }
+
+        const char* copy = intern_arena_copy(shard, str, len);
+        if (copy == NULL){
+            pthread_mutex_unlock(&shard->lock);
+            *out = NULL;
+            return -1;
+        }
+
+        // The table keys on the arena copy, which lives as long as the pool
+        local = shard->count++;
+        shard->strings[local] = copy;
+        ht_insert(shard->table, (void*)copy, (void*)((size_t)local + 1), ht_string_hash);
+
+        shard->stats.unique++;
+        shard->stats.bytes_stored += len;
+        *out = copy;
+    }
+
+    pthread_mutex_unlock(&shard->lock);
+
+    // Shard index in the low bits keeps ids dense within each shard
+    return (local << INTERN_SHARD_BITS) | shard_idx;
+}
+
+/*
+ * This function should return the pool's copy of `str`, copying it into the
+ * pool first if no equal string has been interned yet.  Two calls with equal
+ * strings always return the same pointer, so interned strings can be
+ * compared with ==.  It is safe to call from several threads at once.
+ *
+ * Params:
+ *   pool - the pool to intern into.  May not be NULL.
+ *   str - NUL-terminated string; the pool does not keep this pointer.
+ *
+ * Return:
+ *   Should return the interned copy, or NULL if memory ran out.
+ */
+const char* intern_string(struct intern* pool, const char* str){
+    const char* copy = NULL;
+    intern_locked(pool, str, &copy);
+    return copy;
+}
+
+/*
+ * This function should return a small, stable integer id for `str`,
+ * interning it first if needed.  Equal strings always get the same id, and
+ * the id can be turned back into the string with intern_lookup_id().  It is
+ * safe to call from several threads at once.
+ *
+ * Params:
+ *   pool - the pool to intern into.  May not be NULL.
+ *   str - NUL-terminated string; the pool does not keep this pointer.
+ *
+ * Return:
+ *   Should return the id, or -1 if memory ran out.
+ */
+int intern_id(struct intern* pool, const char* str){
+    const char* copy = NULL;
+    return intern_locked(pool, str, &copy);
+}
+
+/*
+ * This function should return the pool's copy of `str` if an equal string
+ * has already been interned, without storing anything.
+ *
+ * Params:
+ *   pool - the pool to search.  May not be NULL.
+ *   str - NUL-terminated string.
+ *
+ * Return:
+ *   Should return the interned copy, or NULL if `str` was never interned.
+ */
+const char* intern_find(struct intern* pool, const char* str){
+
+    struct intern_shard* shard = intern_shard_for(pool, str);
+    const char* copy = NULL;
+
+    pthread_mutex_lock(&shard->lock);
+
+    void* found = ht_lookup(shard->table, (void*)str, ht_string_hash);
+    if (found != NULL){
+        copy = shard->strings[(size_t)found - 1];
+    }
+
+    pthread_mutex_unlock(&shard->lock);
+
+    return copy;
+}
+
+/*
+ * This function should return the string that was given id `id`.
+ *
+ * Params:
+ *   pool - the pool that returned the id.  May not be NULL.
+ *   id - an id returned by intern_id().
+ *
+ * Return:
+ *   Should return the interned string, or NULL if the id is unknown.
+ */
+const char* intern_lookup_id(struct intern* pool, int id){
+
+    if (id < 0){
+        return NULL;
+    }
+
+    struct intern_shard* shard = &pool->shards[id & (INTERN_SHARDS - 1)];
+    int local = id >> INTERN_SHARD_BITS;
+    const char* copy = NULL;
+
+    // The id array may be reallocated by a concurrent intern
+    pthread_mutex_lock(&shard->lock);
+    if (local < shard->count){
+        copy = shard->strings[local];
+    }
+    pthread_mutex_unlock(&shard->lock);
+
+    return copy;
+}
+
+/*
+ * This function should return the number of distinct strings in the pool.
+ */
+int intern_count(struct intern* pool){
+
+    int count = 0;
+
+    for (int i = 0; i < INTERN_SHARDS; i++){
+        pthread_mutex_lock(&pool->shards[i].lock);
+        count += pool->shards[i].count;
+        pthread_mutex_unlock(&pool->shards[i].lock);
+    }
+
+    return count;
+}
+
+/*
+ * This function should add up the memory counters of every shard.  The
+ * memory saved by interning is bytes_requested - bytes_stored; arena_bytes
+ * is what the pool actually reserved for string data.
+ *
+ * Params:
+ *   pool - the pool to inspect.  May not be NULL.
+ *   stats - filled in with the totals.
+ */
+void intern_stats(struct intern* pool, struct intern_stats* stats){
+
+    memset(stats, 0, sizeof(*stats));
+
+    for (int i = 0; i < INTERN_SHARDS; i++){
+        struct intern_shard* shard = &pool->shards[i];
+
+        pthread_mutex_lock(&shard->lock);
+        stats->calls += shard->stats.calls;
+        stats->unique += shard->stats.unique;
+        stats->bytes_requested += shard->stats.bytes_requested;
+        stats->bytes_stored += shard->stats.bytes_stored;
+        stats->arena_bytes += shard->stats.arena_bytes;
+        pthread_mutex_unlock(&shard->lock);
+    }
+
+    return;
+}
@@ -0,0 +1,105 @@
+/*
+ * This file contains the definition of the interface for the string
+ * interning pool.  You can find descriptions of the pool functions, including
+ * their parameters and their return values, in intern.c.
+ */
+
+#ifndef __INTERN_H
+#define __INTERN_H
+
+#include <stddef.h>
+
+/*
+ * Structure used to represent a string interning pool.
+ */
+struct intern;
+
+/*
+ * Memory counters for a pool.  See intern_stats().
+ */
+struct intern_stats{
+    unsigned long calls; // intern_string/intern_id calls
+    unsigned long unique; // Distinct strings stored
+    size_t bytes_requested; // Bytes (with terminators) of every string passed in
+    size_t bytes_stored; // Bytes (with terminators) of the distinct strings
+    size_t arena_bytes; // Bytes reserved by the arena chunks
+};
+
+/*
+ * Interning pool interface function prototypes.  Refer to intern.c for
+ * documentation about each of these functions.
+ */
+
+/*********************************************************************
+** Function: intern_create
+** Description: Allocate and initialize an empty interning pool
+** Parameters: none
+** Pre-Conditions: none
+** Post-Conditions: Returns pointer to pool, or NULL if allocation fails
+*********************************************************************/
+struct intern* intern_create();
+
+/*********************************************************************
+** Function: intern_free
+** Description: Frees a pool, its table and every string it stores
+** Parameters: struct intern* pool
+** Pre-Conditions: No pointer returned by the pool is used afterwards
+** Post-Conditions: Pool is freed
+*********************************************************************/
+void intern_free(struct intern* pool);
+
+/*********************************************************************
+** Function: intern_string
+** Description: Returns the pool's single copy of a string, storing it if new
+** Parameters: struct intern* pool, const char* str
+** Pre-Conditions: str is NUL-terminated; safe to call from many threads
+** Post-Conditions: Equal strings always return the same pointer
+*********************************************************************/
+const char* intern_string(struct intern* pool, const char* str);
+
+/*********************************************************************
+** Function: intern_id
+** Description: Returns a stable integer id for a string, storing it if new
+** Parameters: struct intern* pool, const char* str
+** Pre-Conditions: str is NUL-terminated; safe to call from many threads
+** Post-Conditions: Equal strings always return the same id, -1 on failure
+*********************************************************************/
+int intern_id(struct intern* pool, const char* str);
+
+/*********************************************************************
+** Function: intern_find
+** Description: Returns the pool's copy of a string without storing it
+** Parameters: struct intern* pool, const char* str
+** Pre-Conditions: str is NUL-terminated
+** Post-Conditions: Returns interned pointer, or NULL if never interned
+*********************************************************************/
+const char* intern_find(struct intern* pool, const char* str);
+
+/*********************************************************************
+** Function: intern_lookup_id
+** Description: Returns the string an id was given to
+** Parameters: struct intern* pool, int id
+** Pre-Conditions: id was returned by intern_id on this pool
+** Post-Conditions: Returns interned pointer, or NULL for an unknown id
+*********************************************************************/
+const char* intern_lookup_id(struct intern* pool, int id);
+
+/*********************************************************************
+** Function: intern_count
+** Description: Returns the number of distinct strings stored
+** Parameters: struct intern* pool
+** Pre-Conditions: none
+** Post-Conditions: Returns count
+*********************************************************************/
+int intern_count(struct intern* pool);
+
+/*********************************************************************
+** Function: intern_stats
+** Description: Reports how much memory interning has saved
+** Parameters: struct intern* pool, struct intern_stats* stats
+** Pre-Conditions: stats is not NULL
+** Post-Conditions: stats is filled in
+*********************************************************************/
+void intern_stats(struct intern* pool, struct intern_stats* stats);
+
+#endif
@@ -0,0 +1,206 @@
+/***********************************************************************
+** Program Filename: intern_bench
+** Date: 10/19/2026
+** Description: Measures the string interning pool on a duplicate-heavy
+corpus: the words of a text file, or without one a generated corpus whose
+word frequencies fall off like natural text (word i appears about 1/i as
+often as the most common one). It times interning every word, finding every
+word again with intern_find, and comparing neighbouring words by strcmp on
+the original strings against a pointer compare on the interned ones, and
+prints intern_stats to show the memory saved.
+** Input: intern_bench [text file], the generated corpus if none is given
+** Output: Timings in nanoseconds per word and the pool's memory counters
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+
+#include "intern.h"
+
+// Words in the generated corpus, and distinct words it draws from
+#define GEN_WORDS 4000000
+#define GEN_VOCABULARY 100000
+
+// Function to return a monotonic time in seconds
+double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Function to split text into words in place, storing up to max_words
+// pointers.  Returns the number of words
+int split_words(char* text, char** words, int max_words){
+	int n = 0;
+	char* c = text;
+
+	while (*c != '\0' && n < max_words){
+		while (*c != '\0' && isspace((unsigned char)*c)){
+			c++;
+		}
+		if (*c == '\0'){
+			break;
+		}
+		words[n++] = c;
+		while (*c != '\0' && !isspace((unsigned char)*c)){
+			c++;
+		}
+		if (*c != '\0'){
+			*c++ = '\0';
+		}
+	}
+
+	return n;
+}
+
+// Function to read a whole file into a NUL-terminated buffer
+char* read_file(const char* path, long* size){
+	FILE* file = fopen(path, "rb");
+	if (file == NULL){
+		return NULL;
+	}
+
+	fseek(file, 0, SEEK_END);
+	*size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	char* text = malloc(*size + 1);
+	if (text == NULL || fread(text, 1, *size, file) != (size_t)*size){
+		free(text);
+		fclose(file);
+		return NULL;
+	}
+	text[*size] = '\0';
+	fclose(file);
+
+	return text;
+}
+
+// Function to write GEN_WORDS words drawn 1/rank from GEN_VOCABULARY words,
+// space separated, into a new buffer
+char* generate_text(long* size){
+	// Cumulative weights of ranks 1..GEN_VOCABULARY
+	double* cumulative = malloc(GEN_VOCABULARY * sizeof(double));
+	char* text = malloc((size_t)GEN_WORDS * 12 + 1);
+	if (cumulative == NULL || text == NULL){
+		free(cumulative);
+		free(text);
+		return NULL;
+	}
+
+	double total = 0;
+	for (int i = 0; i < GEN_VOCABULARY; i++){
+		total += 1.0 / (i + 1);
+		cumulative[i] = total;
+	}
+
+	unsigned state = 2463534242u;
+	char* out = text;
+	for (int w = 0; w < GEN_WORDS; w++){
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		double target = (double)state / 4294967296.0 * total;
+
+		// Binary search for the first rank whose cumulative weight reaches it
+		int lo = 0, hi = GEN_VOCABULARY - 1;
+		while (lo < hi){
+			int mid = (lo + hi) / 2;
+			if (cumulative[mid] < target){
+				lo = mid + 1;
+			}
+			else{
+				hi = mid;
+			}
+		}
+		out += sprintf(out, "word%d ", lo);
+	}
+	*size = out - text;
+
+	free(cumulative);
+	return text;
+}
+
+int main(int argc, char const *argv[]) {
+
+	long size = 0;
+	char* text = argc > 1 ? read_file(argv[1], &size) : generate_text(&size);
+	if (text == NULL){
+		fprintf(stderr, "Could not read %s\n", argc > 1 ? argv[1] : "the generated corpus");
+		return 1;
+	}
+
+	// No word is shorter than a character and a separator
+	int max_words = (int)(size / 2 + 1);
+	char** words = malloc(max_words * sizeof(char*));
+	const char** interned = malloc(max_words * sizeof(char*));
+	if (words == NULL || interned == NULL){
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	int n = split_words(text, words, max_words);
+	if (n < 2){
+		fprintf(stderr, "Need at least two words\n");
+		return 1;
+	}
+
+	struct intern* pool = intern_create();
+	if (pool == NULL){
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	double t = now();
+	for (int i = 0; i < n; i++){
+		interned[i] = intern_string(pool, words[i]);
+	}
+	double intern_ns = (now() - t) * 1e9 / n;
+
+	long long found = 0;
+	t = now();
+	for (int i = 0; i < n; i++){
+		found += intern_find(pool, words[i]) == interned[i];
+	}
+	double find_ns = (now() - t) * 1e9 / n;
+
+	// Equality of neighbouring words, the way a caller would test it
+	long long equal_strcmp = 0, equal_pointer = 0;
+	t = now();
+	for (int i = 1; i < n; i++){
+		equal_strcmp += !strcmp(words[i - 1], words[i]);
+	}
+	double strcmp_ns = (now() - t) * 1e9 / (n - 1);
+
+	t = now();
+	for (int i = 1; i < n; i++){
+		equal_pointer += interned[i - 1] == interned[i];
+	}
+	double pointer_ns = (now() - t) * 1e9 / (n - 1);
+
+	if (found != n || equal_strcmp != equal_pointer){
+		fprintf(stderr, "Interned pointers disagree with the strings\n");
+		return 1;
+	}
+
+	struct intern_stats stats;
+	intern_stats(pool, &stats);
+
+	printf("%d words, %lu distinct\n", n, stats.unique);
+	printf("intern_string  %8.1f ns/word\n", intern_ns);
+	printf("intern_find    %8.1f ns/word\n", find_ns);
+	printf("strcmp equal   %8.2f ns/pair\n", strcmp_ns);
+	printf("pointer equal  %8.2f ns/pair\n", pointer_ns);
+	printf("bytes requested %zu, stored %zu, arena %zu (%.1f%% of requested)\n",
+		stats.bytes_requested, stats.bytes_stored, stats.arena_bytes,
+		100.0 * stats.arena_bytes / stats.bytes_requested);
+
+	intern_free(pool);
+	free(words);
+	free(interned);
+	free(text);
+
+	return 0;
+}
@@ -0,0 +1,286 @@
+/***********************************************************************
+** Program Filename: node_pool
+** Date: 10/19/2026
+** Description: Implementation for a fixed-size node pool. Nodes are bump
+allocated out of slabs that double in size up to a cap, freed nodes go on a
+freelist and are handed out again first, and freeing the pool frees whole
+slabs, so tearing down a tree costs O(slabs) instead of O(n) calls to free.
+Pools can be merged when nodes move between trees; the merged-away pool then
+forwards to the one that took its slabs.
+** Input: None
+** Output: None
+*********************************************************************/
+
+#include <stdlib.h>
+#include <stddef.h>
+
+#include "node_pool.h"
+
+// Nodes in the first slab, each later slab is twice the size of the last
+#define NODE_POOL_FIRST_SLAB 64
+
+// Largest slab, in nodes, so a small tree never reserves a huge slab
+#define NODE_POOL_MAX_SLAB 65536
+
+// Node sizes are rounded up to this, enough for pointers and long long
+#define NODE_POOL_ALIGN 8
+
+/*
+ * One slab of nodes.  `data` is aligned for any type.
+ */
+struct node_pool_slab{
+    struct node_pool_slab* next;
+    max_align_t data[];
+};
+
+/*
+ * This is the structure that represents a pool.  Free nodes are linked
+ * through their first word, and `free_tail` lets a whole freelist be spliced
+ * onto another in O(1) when pools merge.
+ */
+struct node_pool{
+    size_t node_size;
+    int refs;
+    struct node_pool* forward; // Pool this one was merged into, or NULL
+    struct node_pool_slab* slabs;
+    int n_slabs;
+    char* bump; // Next never-used node in the newest slab
+    char* end; // End of the newest slab
+    size_t next_count; // Nodes in the next slab
+    void* free_head;
+    void* free_tail;
+};
+
+// Function to follow merges to the pool that owns the slabs
+struct node_pool* node_pool_resolve(struct node_pool* pool){
+    while (pool->forward != NULL){
+        pool = pool->forward;
+    }
+    return pool;
+}
+
+/*
+ * This function should allocate an empty pool for nodes of `node_size`
+ * bytes.  No memory for nodes is reserved until the first allocation.
+ */
+struct node_pool* node_pool_create(size_t node_size){
+
+    struct node_pool* pool = malloc(sizeof(struct node_pool));
+    if (pool == NULL){
+        return NULL;
+    }
+
+    // Room for the freelist link, and aligned
+    if (node_size < sizeof(void*)){
+        node_size = sizeof(void*);
+    }
+    pool->node_size = (node_size + NODE_POOL_ALIGN - 1) & ~(size_t)(NODE_POOL_ALIGN - 1);
+
+    pool->refs = 1;
+    pool->forward = NULL;
+    pool->slabs = NULL;
+    pool->n_slabs = 0;
+    pool->bump = NULL;
+    pool->end = NULL;
+    pool->next_count = NODE_POOL_FIRST_SLAB;
+    pool->free_head = NULL;
+    pool->free_tail = NULL;
+
+    return pool;
+}
+
+/*
+ * This function should take another reference to a pool, e.g. when two
+ * trees end up sharing nodes.  Each reference is given back with
+ * node_pool_free().
+ */
+struct node_pool* node_pool_retain(struct node_pool* pool){
+    pool->refs++;
+    return pool;
+}
+
+/*
+ * This function should drop a reference to a pool.  When the last one goes,
+ * every slab is freed, which frees every node ever allocated from the pool
+ * in O(slabs).  Pools do not call any per-node destructor.
+ */
+void node_pool_free(struct node_pool* pool){
+
+    while (pool != NULL && --pool->refs == 0){
+        struct node_pool_slab* slab = pool->slabs;
+        while (slab != NULL){
+            struct node_pool_slab* next = slab->next;
+            free(slab);
+            slab = next;
+        }
+
+        // A merged pool held a reference to the one it forwards to
+        struct node_pool* forward = pool->forward;
+        free(pool);
+        pool = forward;
+    }
+}
+
+// Function to add a slab of `count` nodes to the front of the slab list
+struct node_pool_slab* node_pool_add_slab(struct node_pool* pool, size_t count){
+
+    struct node_pool_slab* slab = malloc(sizeof(struct node_pool_slab) + count * pool->node_size);
+    if (slab == NULL){
+        return NULL;
+    }
+
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->n_slabs++;
+
+    return slab;
+}
+
+/*
+ * This function should return memory for one node: a recently freed node if
+ * there is one, otherwise the next unused node of the newest slab, starting
+ * a new slab when that one is full.
+ *
+ * Params:
+ *   pool - the pool to allocate from.  May not be NULL.
+ *
+ * Return:
+ *   Should return the node (uninitialized), or NULL if memory ran out.
+ */
+void* node_pool_alloc(struct node_pool* pool){
+
+    pool = node_pool_resolve(pool);
+
+    // Reuse first, it is probably still in cache
+    if (pool->free_head != NULL){
+        void* node = pool->free_head;
+        pool->free_head = *(void**)node;
+        if (pool->free_head == NULL){
+            pool->free_tail = NULL;
+        }
+        return node;
+    }
+
+    if (pool->bump == pool->end){
+        struct node_pool_slab* slab = node_pool_add_slab(pool, pool->next_count);
+        if (slab == NULL){
+            return NULL;
+        }
+
+        pool->bump = (char*)slab->data;
+        pool->end = pool->bump + pool->next_count * pool->node_size;
+
+        if (pool->next_count < NODE_POOL_MAX_SLAB){
+            pool->next_count *= 2;
+        }
+    }
+
+    void* node = pool->bump;
+    pool->bump += pool->node_size;
+
+    return node;
+}
+
+/*
+ * This function should return `n` contiguous nodes in a slab of their own,
+ * e.g. for building a tree in one pass.  Any of them may later be given
+ * back with node_pool_release() like single nodes.
+ *
+ * Params:
+ *   pool - the pool to allocate from.  May not be NULL.
+ *   n - the number of nodes.
+ *
+ * Return:
+ *   Should return the first node, or NULL if memory ran out.
+ */
+void* node_pool_alloc_array(struct node_pool* pool, size_t n){
+
+    pool = node_pool_resolve(pool);
+
+    struct node_pool_slab* slab = node_pool_add_slab(pool, n);
+    if (slab == NULL){
+        return NULL;
+    }
+
+    return slab->data;
+}
+
+/*
+ * This function should put a node back on the pool's freelist.  Its memory
+ * stays with the pool until the pool is freed.
+ */
+void node_pool_release(struct node_pool* pool, void* node){
+
+    pool = node_pool_resolve(pool);
+
+    *(void**)node = pool->free_head;
+    pool->free_head = node;
+    if (pool->free_tail == NULL){
+        pool->free_tail = node;
+    }
+}
+
+/*
+ * This function should move all slabs and free nodes of `other` into
+ * `pool`, in O(slabs of other), so that nodes from both can live in one
+ * tree.  Afterwards `other` forwards every call to `pool` and keeps `pool`
+ * alive until its own last reference is dropped.
+ *
+ * Params:
+ *   pool - the pool to merge into.  May not be NULL.
+ *   other - the pool to merge.  May not be NULL, may already be the same.
+ */
+void node_pool_merge(struct node_pool* pool, struct node_pool* other){
+
+    pool = node_pool_resolve(pool);
+    other = node_pool_resolve(other);
+
+    if (pool == other){
+        return;
+    }
+
+    // Slabs, other's go in front
+    if (other->slabs != NULL){
+        struct node_pool_slab* last = other->slabs;
+        while (last->next != NULL){
+            last = last->next;
+        }
+        last->next = pool->slabs;
+        pool->slabs = other->slabs;
+        pool->n_slabs += other->n_slabs;
+    }
+
+    // Free nodes, other's list goes in front
+    if (other->free_head != NULL){
+        *(void**)other->free_tail = pool->free_head;
+        if (pool->free_head == NULL){
+            pool->free_tail = other->free_tail;
+        }
+        pool->free_head = other->free_head;
+    }
+
+    // Keep whichever unused slab tail is bigger
+    if (other->end - other->bump > pool->end - pool->bump){
+        pool->bump = other->bump;
+        pool->end = other->end;
+    }
+    if (other->next_count > pool->next_count){
+        pool->next_count = other->next_count;
+    }
+
+    other->slabs = NULL;
+    other->n_slabs = 0;
+    other->bump = NULL;
+    other->end = NULL;
+    other->free_head = NULL;
+    other->free_tail = NULL;
+    other->forward = node_pool_retain(pool);
+}
+
+/*
+ * This function returns the number of slabs the pool holds, which is what
+ * freeing it costs.
+ */
+int node_pool_slabs(struct node_pool* pool){
+    return node_pool_resolve(pool)->n_slabs;
+}
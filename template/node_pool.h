@@ -0,0 +1,94 @@
+/*
+ * This file contains the definition of the interface for the fixed-size node
+ * pool used by the trees.  You can find descriptions of the pool functions,
+ * including their parameters and their return values, in node_pool.c.
+ */
+
+#ifndef __NODE_POOL_H
+#define __NODE_POOL_H
+
+#include <stddef.h>
+
+/*
+ * Structure used to represent a pool of equally sized nodes.
+ */
+struct node_pool;
+
+/*
+ * Node pool interface function prototypes.  Refer to node_pool.c for
+ * documentation about each of these functions.
+ */
+
+/*********************************************************************
+** Function: node_pool_create
+** Description: Allocate an empty pool for nodes of a given size
+** Parameters: size_t node_size
+** Pre-Conditions: node_size > 0
+** Post-Conditions: Returns pointer to pool with one reference, NULL if allocation fails
+*********************************************************************/
+struct node_pool* node_pool_create(size_t node_size);
+
+/*********************************************************************
+** Function: node_pool_retain
+** Description: Takes another reference to a pool
+** Parameters: struct node_pool* pool
+** Pre-Conditions: Pointer to pool
+** Post-Conditions: Returns pool; each reference is dropped with node_pool_free
+*********************************************************************/
+struct node_pool* node_pool_retain(struct node_pool* pool);
+
+/*********************************************************************
+** Function: node_pool_free
+** Description: Drops a reference; the last one frees every node at once
+** Parameters: struct node_pool* pool
+** Pre-Conditions: none
+** Post-Conditions: With no references left, all slabs are freed in O(slabs)
+*********************************************************************/
+void node_pool_free(struct node_pool* pool);
+
+/*********************************************************************
+** Function: node_pool_alloc
+** Description: Returns an uninitialized node, reusing freed ones first
+** Parameters: struct node_pool* pool
+** Pre-Conditions: Pointer to pool
+** Post-Conditions: Returns node, or NULL if allocation fails
+*********************************************************************/
+void* node_pool_alloc(struct node_pool* pool);
+
+/*********************************************************************
+** Function: node_pool_alloc_array
+** Description: Returns n contiguous uninitialized nodes
+** Parameters: struct node_pool* pool, size_t n
+** Pre-Conditions: Pointer to pool, n > 0
+** Post-Conditions: Returns first node, or NULL if allocation fails
+*********************************************************************/
+void* node_pool_alloc_array(struct node_pool* pool, size_t n);
+
+/*********************************************************************
+** Function: node_pool_release
+** Description: Gives a node back to the pool for reuse
+** Parameters: struct node_pool* pool, void* node
+** Pre-Conditions: node came from this pool (or one merged into it)
+** Post-Conditions: node must not be used again
+*********************************************************************/
+void node_pool_release(struct node_pool* pool, void* node);
+
+/*********************************************************************
+** Function: node_pool_merge
+** Description: Moves every node of other into pool
+** Parameters: struct node_pool* pool, struct node_pool* other
+** Pre-Conditions: Both pools have the same node size
+** Post-Conditions: other forwards to pool, so either handle can be used
+*********************************************************************/
+void node_pool_merge(struct node_pool* pool, struct node_pool* other);
+
+/*********************************************************************
+** Function: node_pool_slabs
+** Description: Returns the number of slabs the pool holds
+** Parameters: struct node_pool* pool
+** Pre-Conditions: Pointer to pool
+** Post-Conditions: Returns count
+*********************************************************************/
+int node_pool_slabs(struct node_pool* pool);
+
+#endif
@@ -0,0 +1,575 @@
+/***********************************************************************
+** Program Filename: pbst
+** Date: 10/19/2026
+** Description: Implementation for a persistent binary search tree. Inserts
+and removes never change a node that is already in the tree: they copy the
+nodes on the path to the change and share everything else with the previous
+version. A snapshot is therefore just a counted reference to a version's root
+and costs O(1), and readers never take a lock. The tree is a treap (random
+priorities, expected O(log n) height) so path copies stay short on sorted
+input. Writers are serialized by a mutex; memory that readers may still be
+looking at is freed through epoch-based reclamation.
+** Input: None
+** Output: None
+*********************************************************************/
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "epoch.h"
+#include "pbst.h"
+
+// Reader slots in the epoch domain, more concurrent readers spin briefly
+#define PBST_READERS 128
+
+/*
+ * This structure represents a single node.  Once a node is reachable from a
+ * version it is never modified again, except for `refs`, the number of
+ * parents and snapshot roots pointing at it, which only writers change.
+ * `size` and `sum` cover the node's subtree, as in bst.c.
+ */
+struct pbst_node{
+    int key;
+    void* value;
+    unsigned int priority;
+    int refs;
+    int size;
+    long long sum;
+    struct pbst_node* left;
+    struct pbst_node* right;
+};
+
+/*
+ * This structure represents one version of the tree.  The tree itself holds
+ * one reference to its current version and every snapshot holds another.
+ * A version whose count drops to zero is pushed on the tree's `dropped`
+ * list, without locking, and its nodes are released by the next writer.
+ */
+struct pbst_snapshot{
+    _Atomic int refs;
+    struct pbst_node* root;
+    struct pbst* pbst;
+    struct pbst_snapshot* next_dropped;
+};
+
+/*
+ * This structure represents a tree that can be read and written from many
+ * threads.
+ */
+struct pbst{
+    _Atomic(struct pbst_snapshot*) current;
+    _Atomic(struct pbst_snapshot*) dropped;
+    pthread_mutex_t write_lock;
+    struct epoch* epoch;
+    unsigned int seed; // Priority generator state, writers only
+};
+
+// Function to return the number of nodes below a node
+int pbst_node_size(struct pbst_node* node){
+    return node ? node->size : 0;
+}
+
+// Function to return the key sum below a node
+long long pbst_node_sum(struct pbst_node* node){
+    return node ? node->sum : 0;
+}
+
+// Function to take another reference to a node
+struct pbst_node* pbst_node_acquire(struct pbst_node* node){
+    if (node != NULL){
+        node->refs++;
+    }
+    return node;
+}
+
+// Function to drop a reference to a node, retiring it and releasing its
+// children once nothing points at it
+void pbst_node_release(struct pbst* pbst, struct pbst_node* node){
+
+    while (node != NULL && --node->refs == 0){
+        struct pbst_node* right = node->right;
+
+        pbst_node_release(pbst, node->left);
+
+        // Readers that loaded an older root may still be walking it
+        epoch_retire(pbst->epoch, node, free);
+
+        node = right;
+    }
+}
+
+// Function to create a node that takes over the references `left` and
+// `right`.  On failure both are released and *failed is set
+struct pbst_node* pbst_node_make(struct pbst* pbst, int key, void* value, unsigned int priority, struct pbst_node* left, struct pbst_node* right, int* failed){
+
+    struct pbst_node* node = malloc(sizeof(struct pbst_node));
+    if (node == NULL){
+        pbst_node_release(pbst, left);
+        pbst_node_release(pbst, right);
+        *failed = 1;
+        return NULL;
+    }
+
+    node->key = key;
+    node->value = value;
+    node->priority = priority;
+    node->refs = 1;
+    node->left = left;
+    node->right = right;
+    node->size = pbst_node_size(left) + 1 + pbst_node_size(right);
+    node->sum = pbst_node_sum(left) + key + pbst_node_sum(right);
+
+    return node;
+}
+
+// Function to split the tree at `node` into new trees of keys <= key (*left)
+// and keys > key (*right), copying only the nodes on the search path
+void pbst_split(struct pbst* pbst, struct pbst_node* node, int key, struct pbst_node** left, struct pbst_node** right, int* failed){
+
+    if (node == NULL){
+        *left = NULL;
+        *right = NULL;
+        return;
+    }
+
+    if (node->key <= key){
+        struct pbst_node* rest;
+        pbst_split(pbst, node->right, key, &rest, right, failed);
+        if (*failed){
+            return;
+        }
+
+        *left = pbst_node_make(pbst, node->key, node->value, node->priority, pbst_node_acquire(node->left), rest, failed);
+        if (*failed){
+            pbst_node_release(pbst, *right);
+            *right = NULL;
+        }
+    }
+    else{
+        struct pbst_node* rest;
+        pbst_split(pbst, node->left, key, left, &rest, failed);
+        if (*failed){
+            return;
+        }
+
+        *right = pbst_node_make(pbst, node->key, node->value, node->priority, rest, pbst_node_acquire(node->right), failed);
+        if (*failed){
+            pbst_node_release(pbst, *left);
+            *left = NULL;
+        }
+    }
+}
+
+// Function to return a new version of the tree at `node` with key/value
+// added.  Duplicates go to the right of equal keys, as in bst.c
+struct pbst_node* pbst_insert_node(struct pbst* pbst, struct pbst_node* node, int key, void* value, unsigned int priority, int* failed){
+
+    // The new node belongs here, everything below splits around it
+    if (node == NULL || priority > node->priority){
+        struct pbst_node* left;
+        struct pbst_node* right;
+
+        pbst_split(pbst, node, key, &left, &right, failed);
+        if (*failed){
+            return NULL;
+        }
+        return pbst_node_make(pbst, key, value, priority, left, right, failed);
+    }
+
+    // Otherwise copy this node over a new version of one child
+    if (key < node->key){
+        struct pbst_node* left = pbst_insert_node(pbst, node->left, key, value, priority, failed);
+        if (*failed){
+            return NULL;
+        }
+        return pbst_node_make(pbst, node->key, node->value, node->priority, left, pbst_node_acquire(node->right), failed);
+    }
+
+    struct pbst_node* right = pbst_insert_node(pbst, node->right, key, value, priority, failed);
+    if (*failed){
+        return NULL;
+    }
+    return pbst_node_make(pbst, node->key, node->value, node->priority, pbst_node_acquire(node->left), right, failed);
+}
+
+// Function to join two trees, every key in `left` <= every key in `right`,
+// taking over both references
+struct pbst_node* pbst_merge(struct pbst* pbst, struct pbst_node* left, struct pbst_node* right, int* failed){
+
+    if (left == NULL){
+        return right;
+    }
+    if (right == NULL){
+        return left;
+    }
+
+    // The higher priority root stays on top
+    if (left->priority > right->priority){
+        struct pbst_node* joined = pbst_merge(pbst, pbst_node_acquire(left->right), right, failed);
+        struct pbst_node* node = NULL;
+        if (!*failed){
+            node = pbst_node_make(pbst, left->key, left->value, left->priority, pbst_node_acquire(left->left), joined, failed);
+        }
+        pbst_node_release(pbst, left);
+        return node;
+    }
+
+    struct pbst_node* joined = pbst_merge(pbst, left, pbst_node_acquire(right->left), failed);
+    struct pbst_node* node = NULL;
+    if (!*failed){
+        node = pbst_node_make(pbst, right->key, right->value, right->priority, joined, pbst_node_acquire(right->right), failed);
+    }
+    pbst_node_release(pbst, right);
+    return node;
+}
+
+// Function to return a new version of the tree at `node` without the first
+// node holding `key` on the search path, which must exist
+struct pbst_node* pbst_remove_node(struct pbst* pbst, struct pbst_node* node, int key, int* failed){
+
+    // Found, its two subtrees take its place
+    if (key == node->key){
+        return pbst_merge(pbst, pbst_node_acquire(node->left), pbst_node_acquire(node->right), failed);
+    }
+
+    if (key < node->key){
+        struct pbst_node* left = pbst_remove_node(pbst, node->left, key, failed);
+        if (*failed){
+            return NULL;
+        }
+        return pbst_node_make(pbst, node->key, node->value, node->priority, left, pbst_node_acquire(node->right), failed);
+    }
+
+    struct pbst_node* right = pbst_remove_node(pbst, node->right, key, failed);
+    if (*failed){
+        return NULL;
+    }
+    return pbst_node_make(pbst, node->key, node->value, node->priority, pbst_node_acquire(node->left), right, failed);
+}
+
+// Function to find the first node holding `key` on the search path
+struct pbst_node* pbst_find(struct pbst_node* node, int key){
+
+    while (node != NULL && node->key != key){
+        node = key < node->key ? node->left : node->right;
+    }
+
+    return node;
+}
+
+// Function to drop a reference to a version.  The last reference queues it
+// for the next writer, so this never locks
+void pbst_snapshot_put(struct pbst_snapshot* snap){
+
+    if (atomic_fetch_sub(&snap->refs, 1) != 1){
+        return;
+    }
+
+    struct pbst* pbst = snap->pbst;
+    struct pbst_snapshot* head = atomic_load(&pbst->dropped);
+    do{
+        snap->next_dropped = head;
+    } while (!atomic_compare_exchange_weak(&pbst->dropped, &head, snap));
+}
+
+// Function to release the nodes of every dropped version, write lock held
+void pbst_drain_dropped(struct pbst* pbst){
+
+    struct pbst_snapshot* snap = atomic_exchange(&pbst->dropped, NULL);
+
+    while (snap != NULL){
+        struct pbst_snapshot* next = snap->next_dropped;
+
+        pbst_node_release(pbst, snap->root);
+
+        // A reader may still be trying to take a reference to it
+        epoch_retire(pbst->epoch, snap, free);
+
+        snap = next;
+    }
+}
+
+// Function to make `root` the current version, write lock held.  Returns 0,
+// releasing root, if memory ran out
+int pbst_publish(struct pbst* pbst, struct pbst_node* root){
+
+    struct pbst_snapshot* snap = malloc(sizeof(struct pbst_snapshot));
+    if (snap == NULL){
+        pbst_node_release(pbst, root);
+        return 0;
+    }
+
+    atomic_init(&snap->refs, 1);
+    snap->root = root;
+    snap->pbst = pbst;
+    snap->next_dropped = NULL;
+
+    struct pbst_snapshot* old = atomic_exchange(&pbst->current, snap);
+    pbst_snapshot_put(old);
+
+    return 1;
+}
+
+/*
+ * This function should allocate and initialize a new, empty persistent BST
+ * and return a pointer to it.
+ */
+struct pbst* pbst_create(){
+
+    struct pbst* pbst = malloc(sizeof(struct pbst));
+    if (pbst == NULL){
+        return NULL;
+    }
+
+    pbst->epoch = epoch_create(PBST_READERS);
+    struct pbst_snapshot* empty = malloc(sizeof(struct pbst_snapshot));
+
+    if (pbst->epoch == NULL || empty == NULL){
+        epoch_free(pbst->epoch);
+        free(empty);
+        free(pbst);
+        return NULL;
+    }
+
+    atomic_init(&empty->refs, 1);
+    empty->root = NULL;
+    empty->pbst = pbst;
+    empty->next_dropped = NULL;
+
+    atomic_init(&pbst->current, empty);
+    atomic_init(&pbst->dropped, NULL);
+    pthread_mutex_init(&pbst->write_lock, NULL);
+    pbst->seed = 2463534242U;
+
+    return pbst;
+}
+
+/*
+ * This function should free a persistent BST and every node in it.  All
+ * snapshots must have been released and no other thread may be using the
+ * tree.  It does not free the values stored in it.
+ *
+ * Params:
+ *   pbst - the tree to be destroyed.  May be NULL.
+ */
+void pbst_free(struct pbst* pbst){
+
+    if (pbst == NULL){
+        return;
+    }
+
+    pthread_mutex_lock(&pbst->write_lock);
+    pbst_snapshot_put(atomic_load(&pbst->current));
+    pbst_drain_dropped(pbst);
+    pthread_mutex_unlock(&pbst->write_lock);
+
+    // No readers are left, so everything retired can go
+    epoch_free(pbst->epoch);
+    pthread_mutex_destroy(&pbst->write_lock);
+    free(pbst);
+}
+
+/*
+ * This function should insert a new key/value pair.  The current version is
+ * not changed: a new version is built that copies the O(log n) nodes on the
+ * path to the new key and shares the rest, and then replaces it atomically.
+ * Readers see either the old version or the new one, never a mix.  Writers
+ * run one at a time.
+ *
+ * Params:
+ *   pbst - the tree to insert into.  May not be NULL.
+ *   key - the key to insert.  Duplicates are kept, as in bst.c.
+ *   value - the value to store with it.
+ */
+void pbst_insert(struct pbst* pbst, int key, void* value){
+
+    pthread_mutex_lock(&pbst->write_lock);
+
+    // xorshift32, the treap needs priorities independent of the keys
+    unsigned int x = pbst->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    pbst->seed = x;
+
+    struct pbst_snapshot* cur = atomic_load(&pbst->current);
+    int failed = 0;
+    struct pbst_node* root = pbst_insert_node(pbst, cur->root, key, value, x, &failed);
+
+    if (!failed){
+        pbst_publish(pbst, root);
+    }
+
+    pbst_drain_dropped(pbst);
+    pthread_mutex_unlock(&pbst->write_lock);
+}
+
+/*
+ * This function should remove the key/value pair with `key` that bst_get()
+ * would find, if there is one, by publishing a new version without it.
+ *
+ * Params:
+ *   pbst - the tree to remove from.  May not be NULL.
+ *   key - the key to remove.
+ */
+void pbst_remove(struct pbst* pbst, int key){
+
+    pthread_mutex_lock(&pbst->write_lock);
+
+    struct pbst_snapshot* cur = atomic_load(&pbst->current);
+
+    // Nothing to copy if the key is not there
+    if (pbst_find(cur->root, key) != NULL){
+        int failed = 0;
+        struct pbst_node* root = pbst_remove_node(pbst, cur->root, key, &failed);
+
+        if (!failed){
+            pbst_publish(pbst, root);
+        }
+    }
+
+    pbst_drain_dropped(pbst);
+    pthread_mutex_unlock(&pbst->write_lock);
+}
+
+/*
+ * This function should return the value associated with `key` in the
+ * current version, or NULL if the key is not there.  It takes no lock and
+ * may run at the same time as writers.
+ */
+void* pbst_get(struct pbst* pbst, int key){
+
+    int slot = epoch_enter(pbst->epoch);
+
+    struct pbst_snapshot* cur = atomic_load(&pbst->current);
+    struct pbst_node* node = pbst_find(cur->root, key);
+    void* value = node ? node->value : NULL;
+
+    epoch_exit(pbst->epoch, slot);
+
+    return value;
+}
+
+/*
+ * This function should return the number of pairs in the current version.
+ */
+int pbst_size(struct pbst* pbst){
+
+    int slot = epoch_enter(pbst->epoch);
+    int size = pbst_node_size(atomic_load(&pbst->current)->root);
+    epoch_exit(pbst->epoch, slot);
+
+    return size;
+}
+
+/*
+ * This function should return a snapshot of the current version.  It costs
+ * O(1) (one reference count increment) and takes no lock.  The snapshot
+ * never changes, however the tree is updated afterwards, and must be given
+ * back with pbst_snapshot_release().
+ *
+ * Params:
+ *   pbst - the tree to take a snapshot of.  May not be NULL.
+ *
+ * Return:
+ *   Should return the snapshot.
+ */
+struct pbst_snapshot* pbst_snapshot(struct pbst* pbst){
+
+    int slot = epoch_enter(pbst->epoch);
+    struct pbst_snapshot* snap;
+
+    while (1){
+        snap = atomic_load(&pbst->current);
+
+        // A count of 0 means a writer just replaced it, load the new one
+        int refs = atomic_load(&snap->refs);
+        while (refs > 0 && !atomic_compare_exchange_weak(&snap->refs, &refs, refs + 1)){
+        }
+        if (refs > 0){
+            break;
+        }
+    }
+
+    epoch_exit(pbst->epoch, slot);
+
+    return snap;
+}
+
+/*
+ * This function should give back a snapshot.  Nodes only it was keeping
+ * alive are freed by a later writer, so this never locks.
+ */
+void pbst_snapshot_release(struct pbst_snapshot* snap){
+    pbst_snapshot_put(snap);
+}
+
+/*
+ * This function should return the value associated with `key` in a
+ * snapshot, or NULL if the key is not there.
+ */
+void* pbst_snapshot_get(struct pbst_snapshot* snap, int key){
+    struct pbst_node* node = pbst_find(snap->root, key);
+    return node ? node->value : NULL;
+}
+
+/*
+ * This function should return the number of pairs in a snapshot.
+ */
+int pbst_snapshot_size(struct pbst_snapshot* snap){
+    return pbst_node_size(snap->root);
+}
+
+/*
+ * This function should return the number of keys in a snapshot that are
+ * less than `key`.
+ */
+int pbst_snapshot_rank(struct pbst_snapshot* snap, int key){
+
+    struct pbst_node* node = snap->root;
+    int rank = 0;
+
+    while (node != NULL){
+        if (node->key < key){
+            rank += pbst_node_size(node->left) + 1;
+            node = node->right;
+        }
+        else{
+            node = node->left;
+        }
+    }
+
+    return rank;
+}
+
+// Function to add up every key below `bound` (or up to it when `inclusive`)
+long long pbst_sum_below(struct pbst_node* node, int bound, int inclusive){
+
+    long long sum = 0;
+
+    while (node != NULL){
+        if (node->key < bound || (inclusive && node->key == bound)){
+            sum += pbst_node_sum(node->left) + node->key;
+            node = node->right;
+        }
+        else{
+            node = node->left;
+        }
+    }
+
+    return sum;
+}
+
+/*
+ * This function should return the sum of all keys in a snapshot between
+ * `lower` and `upper` (inclusive), like bst_range_sum().
+ */
+int pbst_snapshot_range_sum(struct pbst_snapshot* snap, int lower, int upper){
+
+    if (lower > upper){
+        return 0;
+    }
+
+    return (int)(pbst_sum_below(snap->root, upper, 1) - pbst_sum_below(snap->root, lower, 0));
+}
@@ -0,0 +1,133 @@
+/*
+ * This file contains the definition of the interface for the persistent
+ * binary search tree.  You can find descriptions of the tree functions,
+ * including their parameters and their return values, in pbst.c.
+ */
+
+#ifndef __PBST_H
+#define __PBST_H
+
+/*
+ * Structure used to represent a persistent BST shared between threads.
+ */
+struct pbst;
+
+/*
+ * Structure used to represent an immutable version of a persistent BST.
+ */
+struct pbst_snapshot;
+
+/*
+ * Persistent BST interface function prototypes.  Refer to pbst.c for
+ * documentation about each of these functions.
+ */
+
+/*********************************************************************
+** Function: pbst_create
+** Description: Allocate and initialize a new, empty persistent BST
+** Parameters: none
+** Pre-Conditions: none
+** Post-Conditions: Returns pointer to tree, or NULL if allocation fails
+*********************************************************************/
+struct pbst* pbst_create();
+
+/*********************************************************************
+** Function: pbst_free
+** Description: Frees every version of the tree and the tree itself
+** Parameters: struct pbst* pbst
+** Pre-Conditions: All snapshots are released, no other thread uses the tree
+** Post-Conditions: Tree is freed, stored values are not
+*********************************************************************/
+void pbst_free(struct pbst* pbst);
+
+/*********************************************************************
+** Function: pbst_insert
+** Description: Publishes a new version with a key/value pair added
+** Parameters: struct pbst* pbst, int key, void* value
+** Pre-Conditions: Pointer to tree; writers are serialized internally
+** Post-Conditions: O(log n) nodes are copied, the rest are shared
+*********************************************************************/
+void pbst_insert(struct pbst* pbst, int key, void* value);
+
+/*********************************************************************
+** Function: pbst_remove
+** Description: Publishes a new version with one pair for a key removed
+** Parameters: struct pbst* pbst, int key
+** Pre-Conditions: Pointer to tree; writers are serialized internally
+** Post-Conditions: Existing snapshots still contain the pair
+*********************************************************************/
+void pbst_remove(struct pbst* pbst, int key);
+
+/*********************************************************************
+** Function: pbst_get
+** Description: Returns the value for a key in the current version, lock-free
+** Parameters: struct pbst* pbst, int key
+** Pre-Conditions: Pointer to tree
+** Post-Conditions: Returns value, NULL if the key is absent
+*********************************************************************/
+void* pbst_get(struct pbst* pbst, int key);
+
+/*********************************************************************
+** Function: pbst_size
+** Description: Returns the number of pairs in the current version, lock-free
+** Parameters: struct pbst* pbst
+** Pre-Conditions: Pointer to tree
+** Post-Conditions: Returns size
+*********************************************************************/
+int pbst_size(struct pbst* pbst);
+
+/*********************************************************************
+** Function: pbst_snapshot
+** Description: Returns the current version in O(1) without locking
+** Parameters: struct pbst* pbst
+** Pre-Conditions: Pointer to tree
+** Post-Conditions: Snapshot never changes; release it with pbst_snapshot_release
+*********************************************************************/
+struct pbst_snapshot* pbst_snapshot(struct pbst* pbst);
+
+/*********************************************************************
+** Function: pbst_snapshot_release
+** Description: Gives back a snapshot without locking
+** Parameters: struct pbst_snapshot* snap
+** Pre-Conditions: snap came from pbst_snapshot and is released once
+** Post-Conditions: snap must not be used again
+*********************************************************************/
+void pbst_snapshot_release(struct pbst_snapshot* snap);
+
+/*********************************************************************
+** Function: pbst_snapshot_get
+** Description: Returns the value for a key in a snapshot
+** Parameters: struct pbst_snapshot* snap, int key
+** Pre-Conditions: Pointer to snapshot
+** Post-Conditions: Returns value, NULL if the key is absent
+*********************************************************************/
+void* pbst_snapshot_get(struct pbst_snapshot* snap, int key);
+
+/*********************************************************************
+** Function: pbst_snapshot_size
+** Description: Returns the number of pairs in a snapshot in O(1)
+** Parameters: struct pbst_snapshot* snap
+** Pre-Conditions: Pointer to snapshot
+** Post-Conditions: Returns size
+*********************************************************************/
+int pbst_snapshot_size(struct pbst_snapshot* snap);
+
+/*********************************************************************
+** Function: pbst_snapshot_rank
+** Description: Returns the number of keys in a snapshot less than a given key
+** Parameters: struct pbst_snapshot* snap, int key
+** Pre-Conditions: Pointer to snapshot
+** Post-Conditions: Returns rank in O(height)
+*********************************************************************/
+int pbst_snapshot_rank(struct pbst_snapshot* snap, int key);
+
+/*********************************************************************
+** Function: pbst_snapshot_range_sum
+** Description: Sums the keys in a snapshot between two bounds (inclusive)
+** Parameters: struct pbst_snapshot* snap, int lower, int upper
+** Pre-Conditions: Pointer to snapshot
+** Post-Conditions: Returns sum in O(height), same result as bst_range_sum
+*********************************************************************/
+int pbst_snapshot_range_sum(struct pbst_snapshot* snap, int lower, int upper);
+
+#endif
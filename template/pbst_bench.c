@@ -0,0 +1,203 @@
+/***********************************************************************
+** Program Filename: pbst_bench
+** Date: 10/19/2026
+** Description: Measures what the persistent tree's versions cost. Updates
+(pbst_insert, pbst_remove) and lookups are timed per operation against the
+mutable tree, plain (bst_create) and red-black (bst_create_balanced), on the
+same random keys. Then snapshots are timed: taking and releasing one with
+pbst_snapshot/pbst_snapshot_release, inserts with and without snapshots
+held, and, for comparison, copying the whole mutable tree, which is how
+a consistent view had to be made without versions.
+** Input: pbst_bench [keys], 1000000 by default
+** Output: Nanoseconds per operation for each tree, and snapshot costs
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "bst.h"
+#include "pbst.h"
+
+// Snapshots taken and released in the snapshot test
+#define SNAPSHOTS 1000000
+
+// Updates between two snapshots in the updates-under-snapshots test
+#define UPDATES_PER_SNAPSHOT 100
+
+// Function to return a monotonic time in seconds
+double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Function to return the next number of a xorshift generator
+unsigned next_random(unsigned* state){
+	unsigned x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+// Function to time n inserts, n lookups and n / 2 removes on a mutable
+// tree, printing one row
+void bench_bst(const char* name, struct bst* bst, int* keys, int* lookups, int n){
+	long long found = 0;
+
+	double t = now();
+	for (int i = 0; i < n; i++){
+		bst_insert(bst, keys[i], &keys[i]);
+	}
+	double insert = now() - t;
+
+	t = now();
+	for (int i = 0; i < n; i++){
+		found += bst_get(bst, lookups[i]) != NULL;
+	}
+	double get = now() - t;
+
+	t = now();
+	for (int i = 0; i < n / 2; i++){
+		bst_remove(bst, lookups[i]);
+	}
+	double remove = now() - t;
+
+	printf("%-7s %10.1f %10.1f %10.1f%s\n", name, insert * 1e9 / n, get * 1e9 / n,
+		remove * 1e9 / (n / 2 > 0 ? n / 2 : 1), found != n ? " (keys missing)" : "");
+}
+
+// Function to do the same on the persistent tree
+void bench_pbst(struct pbst* pbst, int* keys, int* lookups, int n){
+	long long found = 0;
+
+	double t = now();
+	for (int i = 0; i < n; i++){
+		pbst_insert(pbst, keys[i], &keys[i]);
+	}
+	double insert = now() - t;
+
+	t = now();
+	for (int i = 0; i < n; i++){
+		found += pbst_get(pbst, lookups[i]) != NULL;
+	}
+	double get = now() - t;
+
+	t = now();
+	for (int i = 0; i < n / 2; i++){
+		pbst_remove(pbst, lookups[i]);
+	}
+	double remove = now() - t;
+
+	printf("%-7s %10.1f %10.1f %10.1f%s\n", "pbst", insert * 1e9 / n, get * 1e9 / n,
+		remove * 1e9 / (n / 2 > 0 ? n / 2 : 1), found != n ? " (keys missing)" : "");
+}
+
+int main(int argc, char const *argv[]) {
+
+	int n = argc > 1 ? atoi(argv[1]) : 1000000;
+	if (n < 2){
+		fprintf(stderr, "Usage: %s [keys]\n", argv[0]);
+		return 1;
+	}
+
+	int* keys = malloc(n * sizeof(int));
+	int* lookups = malloc(n * sizeof(int));
+	int* sorted = malloc(n * sizeof(int));
+	if (keys == NULL || lookups == NULL || sorted == NULL){
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	// Even keys, inserted in one random order and looked up in another
+	unsigned state = 2463534242u;
+	for (int i = 0; i < n; i++){
+		keys[i] = 2 * i;
+	}
+	for (int i = n - 1; i > 0; i--){
+		int j = next_random(&state) % (i + 1);
+		int swap = keys[i];
+		keys[i] = keys[j];
+		keys[j] = swap;
+	}
+	for (int i = 0; i < n; i++){
+		lookups[i] = keys[i];
+	}
+	for (int i = n - 1; i > 0; i--){
+		int j = next_random(&state) % (i + 1);
+		int swap = lookups[i];
+		lookups[i] = lookups[j];
+		lookups[j] = swap;
+	}
+
+	printf("%d keys, nanoseconds per operation\n", n);
+	printf("%-7s %10s %10s %10s\n", "tree", "insert", "get", "remove");
+
+	struct bst* bst = bst_create();
+	struct bst* balanced = bst_create_balanced();
+	struct pbst* pbst = pbst_create();
+	if (bst == NULL || balanced == NULL || pbst == NULL){
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	bench_bst("bst", bst, keys, lookups, n);
+	bench_bst("bst-rb", balanced, keys, lookups, n);
+	bench_pbst(pbst, keys, lookups, n);
+	bst_free(bst);
+
+	// The trees now hold n - n / 2 keys
+	int size = pbst_size(pbst);
+	printf("\nsnapshots of %d keys\n", size);
+
+	double t = now();
+	for (int i = 0; i < SNAPSHOTS; i++){
+		pbst_snapshot_release(pbst_snapshot(pbst));
+	}
+	printf("  pbst_snapshot + release     %12.1f ns\n", (now() - t) * 1e9 / SNAPSHOTS);
+
+	// The removed keys go back in, first with no snapshot held, then
+	// again while the snapshot taken before each update is still held
+	int updates = n / 2;
+	t = now();
+	for (int i = 0; i < updates; i++){
+		pbst_insert(pbst, lookups[i], &lookups[i]);
+	}
+	printf("  insert, no snapshot held    %12.1f ns\n", (now() - t) * 1e9 / updates);
+	for (int i = 0; i < updates; i++){
+		pbst_remove(pbst, lookups[i]);
+	}
+
+	struct pbst_snapshot* held = pbst_snapshot(pbst);
+	t = now();
+	for (int i = 0; i < updates; i++){
+		if (i % UPDATES_PER_SNAPSHOT == 0){
+			pbst_snapshot_release(held);
+			held = pbst_snapshot(pbst);
+		}
+		pbst_insert(pbst, lookups[i], &lookups[i]);
+	}
+	pbst_snapshot_release(held);
+	printf("  insert under snapshots      %12.1f ns\n", (now() - t) * 1e9 / updates);
+
+	// Without versions, a consistent view is a full copy of the tree
+	t = now();
+	struct bst_iterator* iter = bst_iterator_create(balanced);
+	int copied = 0;
+	while (bst_iterator_has_next(iter)){
+		sorted[copied++] = bst_iterator_next(iter, NULL);
+	}
+	bst_iterator_free(iter);
+	struct bst* copy = bst_build_from_sorted(sorted, NULL, copied);
+	printf("  copy of the mutable tree    %12.1f ms (%d keys)\n", (now() - t) * 1e3, copied);
+
+	bst_free(copy);
+	bst_free(balanced);
+	pbst_free(pbst);
+	free(keys);
+	free(lookups);
+	free(sorted);
+
+	return 0;
+}
@@ -92,7 +92,7 @@ void pq_free(struct pq* pq) {
  */
 int pq_isempty(struct pq* pq) {
 	
-	return isdynarray_empty(pq->dynarray);
+	return dynarray_size(pq->dynarray) == 0;
 }
 
 void percolateUp(struct pq* pq, struct pq_element* pq_elem){
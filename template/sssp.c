@@ -0,0 +1,303 @@
+/***********************************************************************
+** Program Filename: sssp
+** Date: 10/19/2026
+** Description: Implementation for single-source shortest paths over a CSR
+graph, meant to be called many times in a row. A context owns the distance,
+predecessor and heap buffers and keeps them between queries. Instead of
+clearing V entries before every query, each entry carries the number of the
+query that last wrote it, and anything older reads as unreached, so starting a
+query costs O(1) and a query touches only the nodes it reaches.
+** Input: None
+** Output: None
+*********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "sssp.h"
+
+// Heap capacity of a new context, grown by doubling
+#define SSSP_FIRST_HEAP 64
+
+/*
+ * One heap entry.  Entries are never updated in place: a cheaper path pushes
+ * a new entry and the old one is skipped when it comes out.
+ */
+struct sssp_entry{
+    int dist;
+    int node;
+};
+
+/*
+ * This is the structure that represents a context.  dist[v] and pred[v] are
+ * valid for the current query only when seen[v] == query, and v's cost is
+ * final when done[v] == query.
+ */
+struct sssp_context{
+    int capacity; // Nodes the buffers have room for
+    unsigned query; // Number of the current query, never 0
+    int* dist;
+    int* pred;
+    unsigned* seen;
+    unsigned* done;
+    struct sssp_entry* heap; // Binary min-heap on dist
+    long long heap_size;
+    long long heap_capacity;
+};
+
+// Function to make the node buffers big enough for n_nodes nodes
+int sssp_reserve(struct sssp_context* ctx, int n_nodes){
+
+    if (n_nodes <= ctx->capacity){
+        return 1;
+    }
+
+    int* dist = malloc(n_nodes * sizeof(int));
+    int* pred = malloc(n_nodes * sizeof(int));
+    unsigned* seen = calloc(n_nodes, sizeof(unsigned));
+    unsigned* done = calloc(n_nodes, sizeof(unsigned));
+
+    if (dist == NULL || pred == NULL || seen == NULL || done == NULL){
+        free(dist);
+        free(pred);
+        free(seen);
+        free(done);
+        return 0;
+    }
+
+    // Fresh stamps are all 0, which no query uses, so nothing needs copying
+    free(ctx->dist);
+    free(ctx->pred);
+    free(ctx->seen);
+    free(ctx->done);
+
+    ctx->dist = dist;
+    ctx->pred = pred;
+    ctx->seen = seen;
+    ctx->done = done;
+    ctx->capacity = n_nodes;
+
+    return 1;
+}
+
+/*
+ * This function should allocate a context with buffers for graphs of up to
+ * `n_nodes` nodes.  A query on a bigger graph grows them once.
+ */
+struct sssp_context* sssp_context_create(int n_nodes){
+
+    struct sssp_context* ctx = malloc(sizeof(struct sssp_context));
+    if (ctx == NULL){
+        return NULL;
+    }
+
+    ctx->capacity = 0;
+    ctx->query = 0;
+    ctx->dist = NULL;
+    ctx->pred = NULL;
+    ctx->seen = NULL;
+    ctx->done = NULL;
+    ctx->heap = malloc(SSSP_FIRST_HEAP * sizeof(struct sssp_entry));
+    ctx->heap_size = 0;
+    ctx->heap_capacity = SSSP_FIRST_HEAP;
+
+    if (ctx->heap == NULL || !sssp_reserve(ctx, n_nodes)){
+        sssp_context_free(ctx);
+        return NULL;
+    }
+
+    return ctx;
+}
+
+/*
+ * This function should free a context and its buffers.
+ */
+void sssp_context_free(struct sssp_context* ctx){
+
+    if (ctx == NULL){
+        return;
+    }
+
+    free(ctx->dist);
+    free(ctx->pred);
+    free(ctx->seen);
+    free(ctx->done);
+    free(ctx->heap);
+    free(ctx);
+}
+
+// Function to add an entry to the heap, growing it if full
+int sssp_heap_push(struct sssp_context* ctx, int dist, int node){
+
+    if (ctx->heap_size == ctx->heap_capacity){
+        struct sssp_entry* heap = realloc(ctx->heap, 2 * ctx->heap_capacity * sizeof(struct sssp_entry));
+        if (heap == NULL){
+            return 0;
+        }
+        ctx->heap = heap;
+        ctx->heap_capacity *= 2;
+    }
+
+    // Move the hole up until the parent is no larger
+    struct sssp_entry* heap = ctx->heap;
+    long long i = ctx->heap_size++;
+    while (i > 0 && heap[(i - 1) / 2].dist > dist){
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i].dist = dist;
+    heap[i].node = node;
+
+    return 1;
+}
+
+// Function to remove and return the heap's smallest entry
+struct sssp_entry sssp_heap_pop(struct sssp_context* ctx){
+
+    struct sssp_entry* heap = ctx->heap;
+    struct sssp_entry first = heap[0];
+    struct sssp_entry last = heap[--ctx->heap_size];
+    long long n = ctx->heap_size;
+
+    // Move the hole down from the root, then drop the last entry into it
+    long long i = 0;
+    while (2 * i + 1 < n){
+        long long child = 2 * i + 1;
+        if (child + 1 < n && heap[child + 1].dist < heap[child].dist){
+            child++;
+        }
+        if (heap[child].dist >= last.dist){
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+
+    return first;
+}
+
+// Function to start a new query, invalidating every result of the last one
+void sssp_begin(struct sssp_context* ctx){
+
+    ctx->heap_size = 0;
+    ctx->query++;
+
+    // After 2^32 queries the stamps wrap; clear them once so none can match
+    if (ctx->query == 0){
+        memset(ctx->seen, 0, ctx->capacity * sizeof(unsigned));
+        memset(ctx->done, 0, ctx->capacity * sizeof(unsigned));
+        ctx->query = 1;
+    }
+}
+
+// Function to run Dijkstra from source, stopping at target if it is >= 0
+int sssp_search(struct sssp_context* ctx, struct csr_graph* graph, int source, int target){
+
+    if (!sssp_reserve(ctx, graph->n_nodes)){
+        return 0;
+    }
+
+    sssp_begin(ctx);
+
+    unsigned query = ctx->query;
+    int* dist = ctx->dist;
+    int* pred = ctx->pred;
+    unsigned* seen = ctx->seen;
+    unsigned* done = ctx->done;
+
+    dist[source] = 0;
+    pred[source] = -1;
+    seen[source] = query;
+    if (!sssp_heap_push(ctx, 0, source)){
+        return 0;
+    }
+
+    while (ctx->heap_size > 0){
+        struct sssp_entry entry = sssp_heap_pop(ctx);
+        int node = entry.node;
+
+        // Later entries for a node are stale
+        if (done[node] == query){
+            continue;
+        }
+        done[node] = query;
+
+        if (node == target){
+            break;
+        }
+
+        for (long long e = graph->offsets[node]; e < graph->offsets[node + 1]; e++){
+            int neighbor = graph->targets[e];
+            long long total_cost = (long long)entry.dist + graph->weights[e];
+
+            // Costs that would reach SSSP_INF are treated as unreachable
+            if (done[neighbor] == query || total_cost >= SSSP_INF){
+                continue;
+            }
+
+            if (seen[neighbor] != query || total_cost < dist[neighbor]){
+                dist[neighbor] = (int)total_cost;
+                pred[neighbor] = node;
+                seen[neighbor] = query;
+                if (!sssp_heap_push(ctx, (int)total_cost, neighbor)){
+                    return 0;
+                }
+            }
+        }
+    }
+
+    return 1;
+}
+
+/*
+ * This function should find the least-cost paths from `source` to every
+ * node of `graph`, replacing the results of the previous query.  No memory
+ * is allocated once the context has served a graph at least this big.
+ *
+ * Params:
+ *   ctx - the context to run in.  May not be NULL.
+ *   graph - the graph, with non-negative weights.  May not be NULL.
+ *   source - the node to start from.
+ *
+ * Return:
+ *   Should return 1, or 0 if memory could not be allocated.
+ */
+int sssp_run(struct sssp_context* ctx, struct csr_graph* graph, int source){
+    return sssp_search(ctx, graph, source, -1);
+}
+
+/*
+ * This function should find the least-cost path from `source` to `target`,
+ * stopping as soon as it is known.  Nodes that were reached on the way can
+ * be read too, but only target's cost and its chain of previous nodes are
+ * guaranteed final.
+ *
+ * Params:
+ *   ctx - the context to run in.  May not be NULL.
+ *   graph - the graph, with non-negative weights.  May not be NULL.
+ *   source - the node to start from.
+ *   target - the node to stop at.
+ *
+ * Return:
+ *   Should return 1, or 0 if memory could not be allocated.
+ */
+int sssp_run_to(struct sssp_context* ctx, struct csr_graph* graph, int source, int target){
+    return sssp_search(ctx, graph, source, target);
+}
+
+/*
+ * This function returns the cost of the least-cost path to `node` found by
+ * the last query, or SSSP_INF if the query did not reach it.
+ */
+int sssp_dist(struct sssp_context* ctx, int node){
+    return ctx->seen[node] == ctx->query ? ctx->dist[node] : SSSP_INF;
+}
+
+/*
+ * This function returns the node before `node` on the path found by the last
+ * query, or -1 for the source and for nodes the query did not reach.
+ */
+int sssp_pred(struct sssp_context* ctx, int node){
+    return ctx->seen[node] == ctx->query ? ctx->pred[node] : -1;
+}
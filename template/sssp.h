@@ -0,0 +1,83 @@
+/*
+ * This file contains the definition of the interface for single-source
+ * shortest paths over a CSR graph.  You can find descriptions of the SSSP
+ * functions, including their parameters and their return values, in sssp.c.
+ */
+
+#ifndef __SSSP_H
+#define __SSSP_H
+
+#include <limits.h>
+
+#include "csr_graph.h"
+
+// Distance reported for a node the last query did not reach
+#define SSSP_INF INT_MAX
+
+/*
+ * Structure used to hold the buffers of shortest-path queries.  One context
+ * can answer any number of queries, on any graph, without allocating once its
+ * buffers are big enough; it is not safe to share between threads.
+ */
+struct sssp_context;
+
+/*
+ * SSSP interface function prototypes.  Refer to sssp.c for documentation
+ * about each of these functions.
+ */
+
+/*********************************************************************
+** Function: sssp_context_create
+** Description: Allocate a context with buffers for graphs of up to n_nodes nodes
+** Parameters: int n_nodes
+** Pre-Conditions: n_nodes >= 0; bigger graphs grow the buffers on first use
+** Post-Conditions: Returns pointer to context, NULL if allocation fails
+*********************************************************************/
+struct sssp_context* sssp_context_create(int n_nodes);
+
+/*********************************************************************
+** Function: sssp_context_free
+** Description: Frees a context and its buffers
+** Parameters: struct sssp_context* ctx
+** Pre-Conditions: none
+** Post-Conditions: Context is freed
+*********************************************************************/
+void sssp_context_free(struct sssp_context* ctx);
+
+/*********************************************************************
+** Function: sssp_run
+** Description: Finds least-cost paths from source to every node (Dijkstra)
+** Parameters: struct sssp_context* ctx, struct csr_graph* graph, int source
+** Pre-Conditions: Weights are >= 0, 0 <= source < n_nodes
+** Post-Conditions: Returns 1 and replaces the previous query's results, 0 if allocation fails
+*********************************************************************/
+int sssp_run(struct sssp_context* ctx, struct csr_graph* graph, int source);
+
+/*********************************************************************
+** Function: sssp_run_to
+** Description: Like sssp_run, but stops as soon as target's cost is final
+** Parameters: struct sssp_context* ctx, struct csr_graph* graph, int source, int target
+** Pre-Conditions: Weights are >= 0, source and target are nodes of the graph
+** Post-Conditions: Returns 1, 0 if allocation fails; only target's results are guaranteed final
+*********************************************************************/
+int sssp_run_to(struct sssp_context* ctx, struct csr_graph* graph, int source, int target);
+
+/*********************************************************************
+** Function: sssp_dist
+** Description: Returns the cost of the least-cost path found to a node
+** Parameters: struct sssp_context* ctx, int node
+** Pre-Conditions: A query has run on a graph containing node
+** Post-Conditions: Returns cost, SSSP_INF if the node was not reached
+*********************************************************************/
+int sssp_dist(struct sssp_context* ctx, int node);
+
+/*********************************************************************
+** Function: sssp_pred
+** Description: Returns the node before a node on its least-cost path
+** Parameters: struct sssp_context* ctx, int node
+** Pre-Conditions: A query has run on a graph containing node
+** Post-Conditions: Returns previous node, -1 for the source and unreached nodes
+*********************************************************************/
+int sssp_pred(struct sssp_context* ctx, int node);
+
+#endif
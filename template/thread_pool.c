@@ -0,0 +1,219 @@
+/***********************************************************************
+** Program Filename: thread_pool
+** Date: 10/19/2026
+** Description: Implementation for a small fork-join thread pool. Tasks go
+on one shared stack; workers take the newest one. A thread waiting for a task
+runs other queued tasks instead of sleeping, so recursive divide-and-conquer
+code can spawn and wait at every level without running out of threads.
+** Input: None
+** Output: None
+*********************************************************************/
+
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "thread_pool.h"
+
+/*
+ * One queued or running task.  `done` is only read and written under the
+ * pool's lock.
+ */
+struct thread_pool_task{
+    void (*fn)(void*);
+    void* arg;
+    int done;
+    struct thread_pool_task* next;
+};
+
+/*
+ * This is the structure that represents a pool.  `wake` is signalled when a
+ * task is queued, when one finishes, and when the pool shuts down.
+ */
+struct thread_pool{
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    struct thread_pool_task* tasks; // Newest first
+    int stop;
+    int n_threads;
+    pthread_t* threads;
+};
+
+// Function to run one task and mark it finished, lock not held
+void thread_pool_run(struct thread_pool* pool, struct thread_pool_task* task){
+
+    task->fn(task->arg);
+
+    pthread_mutex_lock(&pool->lock);
+    task->done = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Function to pop the newest task, lock held
+struct thread_pool_task* thread_pool_pop(struct thread_pool* pool){
+
+    struct thread_pool_task* task = pool->tasks;
+    if (task != NULL){
+        pool->tasks = task->next;
+    }
+
+    return task;
+}
+
+// Function each worker thread runs until the pool stops
+void* thread_pool_worker(void* arg){
+
+    struct thread_pool* pool = arg;
+
+    pthread_mutex_lock(&pool->lock);
+    while (1){
+        while (!pool->stop && pool->tasks == NULL){
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->tasks == NULL){
+            break;
+        }
+
+        struct thread_pool_task* task = thread_pool_pop(pool);
+        pthread_mutex_unlock(&pool->lock);
+        thread_pool_run(pool, task);
+        pthread_mutex_lock(&pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+/*
+ * This function should start a pool of `n_threads` workers.  A pool with no
+ * workers is valid: spawned tasks then run inside thread_pool_wait().
+ */
+struct thread_pool* thread_pool_create(int n_threads){
+
+    struct thread_pool* pool = malloc(sizeof(struct thread_pool));
+    if (pool == NULL){
+        return NULL;
+    }
+
+    if (n_threads < 0){
+        n_threads = 0;
+    }
+
+    pool->threads = malloc((n_threads > 0 ? n_threads : 1) * sizeof(pthread_t));
+    if (pool->threads == NULL){
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pool->tasks = NULL;
+    pool->stop = 0;
+    pool->n_threads = 0;
+
+    // Keep however many threads could be started
+    for (int i = 0; i < n_threads; i++){
+        if (pthread_create(&pool->threads[i], NULL, thread_pool_worker, pool) != 0){
+            break;
+        }
+        pool->n_threads++;
+    }
+
+    return pool;
+}
+
+/*
+ * This function should stop every worker and free the pool.  All spawned
+ * tasks must have been waited for.
+ */
+void thread_pool_free(struct thread_pool* pool){
+
+    if (pool == NULL){
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->n_threads; i++){
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->threads);
+    free(pool);
+}
+
+/*
+ * This function returns the number of worker threads in the pool.
+ */
+int thread_pool_size(struct thread_pool* pool){
+    return pool->n_threads;
+}
+
+/*
+ * This function should queue `fn(arg)` to run on some thread of the pool.
+ * Every task must later be passed to thread_pool_wait().
+ *
+ * Params:
+ *   pool - the pool to run on.  May not be NULL.
+ *   fn - the function to run.
+ *   arg - passed to fn.
+ *
+ * Return:
+ *   Should return the task, or NULL if memory ran out, in which case the
+ *   caller should run fn(arg) itself.
+ */
+struct thread_pool_task* thread_pool_spawn(struct thread_pool* pool, void (*fn)(void*), void* arg){
+
+    struct thread_pool_task* task = malloc(sizeof(struct thread_pool_task));
+    if (task == NULL){
+        return NULL;
+    }
+
+    task->fn = fn;
+    task->arg = arg;
+    task->done = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    task->next = pool->tasks;
+    pool->tasks = task;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    return task;
+}
+
+/*
+ * This function should return once `task` has finished, then free it.
+ * While it waits the calling thread runs other queued tasks (often the task
+ * itself, if no worker has taken it yet), so waiting never ties up a thread
+ * and nested spawns cannot deadlock.
+ *
+ * Params:
+ *   pool - the pool the task was spawned on.  May not be NULL.
+ *   task - the task to wait for.
+ */
+void thread_pool_wait(struct thread_pool* pool, struct thread_pool_task* task){
+
+    pthread_mutex_lock(&pool->lock);
+    while (!task->done){
+        struct thread_pool_task* other = thread_pool_pop(pool);
+
+        // Help out instead of sleeping
+        if (other != NULL){
+            pthread_mutex_unlock(&pool->lock);
+            thread_pool_run(pool, other);
+            pthread_mutex_lock(&pool->lock);
+        }
+        else{
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    free(task);
+}
@@ -0,0 +1,70 @@
+/*
+ * This file contains the definition of the interface for a fork-join thread
+ * pool.  You can find descriptions of the pool functions, including their
+ * parameters and their return values, in thread_pool.c.
+ */
+
+#ifndef __THREAD_POOL_H
+#define __THREAD_POOL_H
+
+/*
+ * Structure used to represent a pool of worker threads.
+ */
+struct thread_pool;
+
+/*
+ * Structure used to represent one task handed to a pool.
+ */
+struct thread_pool_task;
+
+/*
+ * Thread pool interface function prototypes.  Refer to thread_pool.c for
+ * documentation about each of these functions.
+ */
+
+/*********************************************************************
+** Function: thread_pool_create
+** Description: Starts a pool with a number of worker threads
+** Parameters: int n_threads
+** Pre-Conditions: n_threads >= 0
+** Post-Conditions: Returns pointer to pool, or NULL if allocation fails
+*********************************************************************/
+struct thread_pool* thread_pool_create(int n_threads);
+
+/*********************************************************************
+** Function: thread_pool_free
+** Description: Stops the workers and frees the pool
+** Parameters: struct thread_pool* pool
+** Pre-Conditions: Every spawned task has been waited for
+** Post-Conditions: Pool is freed
+*********************************************************************/
+void thread_pool_free(struct thread_pool* pool);
+
+/*********************************************************************
+** Function: thread_pool_size
+** Description: Returns the number of worker threads
+** Parameters: struct thread_pool* pool
+** Pre-Conditions: Pointer to pool
+** Post-Conditions: Returns count
+*********************************************************************/
+int thread_pool_size(struct thread_pool* pool);
+
+/*********************************************************************
+** Function: thread_pool_spawn
+** Description: Queues fn(arg) to run on the pool
+** Parameters: struct thread_pool* pool, void (*fn)(void*), void* arg
+** Pre-Conditions: Pointer to pool
+** Post-Conditions: Returns task to wait on, NULL if allocation fails (nothing queued)
+*********************************************************************/
+struct thread_pool_task* thread_pool_spawn(struct thread_pool* pool, void (*fn)(void*), void* arg);
+
+/*********************************************************************
+** Function: thread_pool_wait
+** Description: Waits for a task, running queued tasks meanwhile
+** Parameters: struct thread_pool* pool, struct thread_pool_task* task
+** Pre-Conditions: task came from thread_pool_spawn on this pool
+** Post-Conditions: Task has finished and is freed
+*********************************************************************/
+void thread_pool_wait(struct thread_pool* pool, struct thread_pool_task* task);
+
+#endif
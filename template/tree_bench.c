@@ -0,0 +1,289 @@
+/***********************************************************************
+** Program Filename: tree_bench
+** Date: 10/19/2026
+** Description: Compares the ordered maps in this directory, the B+tree
+(bplus), the binary search tree, plain (bst) and red-black (bst-rb), and the
+AVL tree (avl), on the same keys: inserting them in random order, looking them up in random order,
+range scans (a seek and then the next 1000 keys in order), a full scan of
+every key in order, removing them in random order, building the whole map
+at once from sorted keys, and a full scan of the built map. A second table
+inserts the keys in sorted, reverse-sorted and random order and looks every
+key up afterwards.
+** Input: tree_bench [keys], 1000000 by default
+** Output: Tables of nanoseconds per key for each map and operation
+*********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "avl.h"
+#include "bplus.h"
+#include "bst.h"
+
+// Keys read after each seek of the scan test
+#define SCAN_LENGTH 1000
+
+// Sorted inserts turn the plain bst into a list, O(n^2) in all, so it runs
+// the ordered tests on at most this many keys
+#define DEGENERATE_MAX 20000
+
+/*
+ * The operations the benchmark runs, so every map goes through the same
+ * code.  scan returns the sum of the keys it read so the work is kept.
+ */
+struct engine{
+	const char* name;
+	void* (*create)();
+	void* (*build)(int* keys, int n);
+	void (*insert)(void* map, int key, void* value);
+	void* (*get)(void* map, int key);
+	long long (*scan)(void* map, int key, int count);
+	void (*remove)(void* map, int key);
+	void (*free)(void* map);
+	int degenerate; // Sorted inserts make it a list
+};
+
+// Function to return a monotonic time in seconds
+double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Functions to run each operation on the B+tree
+void* bench_bplus_create(){ return bplus_create(); }
+void* bench_bplus_build(int* keys, int n){ return bplus_build_from_sorted(keys, NULL, n); }
+void bench_bplus_insert(void* map, int key, void* value){ bplus_insert(map, key, value); }
+void* bench_bplus_get(void* map, int key){ return bplus_get(map, key); }
+void bench_bplus_remove(void* map, int key){ bplus_remove(map, key); }
+void bench_bplus_free(void* map){ bplus_free(map); }
+
+long long bench_bplus_scan(void* map, int key, int count){
+	long long sum = 0;
+	struct bplus_iterator* iter = bplus_iterator_create(map);
+	bplus_iterator_seek(iter, key);
+	for (int i = 0; i < count && bplus_iterator_has_next(iter); i++){
+		sum += bplus_iterator_next(iter, NULL);
+	}
+	bplus_iterator_free(iter);
+	return sum;
+}
+
+// Functions to run each operation on the binary search tree
+void* bench_bst_create(){ return bst_create(); }
+void* bench_bst_balanced_create(){ return bst_create_balanced(); }
+void* bench_bst_build(int* keys, int n){ return bst_build_from_sorted(keys, NULL, n); }
+void bench_bst_insert(void* map, int key, void* value){ bst_insert(map, key, value); }
+void* bench_bst_get(void* map, int key){ return bst_get(map, key); }
+void bench_bst_remove(void* map, int key){ bst_remove(map, key); }
+void bench_bst_free(void* map){ bst_free(map); }
+
+long long bench_bst_scan(void* map, int key, int count){
+	long long sum = 0;
+	struct bst_iterator* iter = bst_iterator_create(map);
+	bst_iterator_seek(iter, key);
+	for (int i = 0; i < count && bst_iterator_has_next(iter); i++){
+		sum += bst_iterator_next(iter, NULL);
+	}
+	bst_iterator_free(iter);
+	return sum;
+}
+
+// Functions to run each operation on the AVL tree
+void* bench_avl_create(){ return avl_create(); }
+void bench_avl_insert(void* map, int key, void* value){ avl_insert(map, key, value); }
+void* bench_avl_get(void* map, int key){ return avl_get(map, key); }
+void bench_avl_remove(void* map, int key){ avl_remove(map, key); }
+void bench_avl_free(void* map){ avl_free(map); }
+
+void* bench_avl_build(int* keys, int n){
+	struct avl_tree* avl = avl_create();
+	avl_insert_batch(avl, keys, NULL, n);
+	return avl;
+}
+
+long long bench_avl_scan(void* map, int key, int count){
+	long long sum = 0;
+	struct avl_iterator iter;
+	avl_iterator_seek(&iter, map, key);
+	for (int i = 0; i < count && avl_iterator_has_next(&iter); i++){
+		sum += avl_iterator_next(&iter, NULL);
+	}
+	return sum;
+}
+
+// Function to return the next number of a xorshift generator
+unsigned next_random(unsigned* state){
+	unsigned x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+// Function to run every test on one map and print its row
+void bench_engine(struct engine* e, int* sorted, int* shuffled, int* lookups, int n){
+	double t, insert, get, scan, full, remove, build, built_scan;
+	long long sink = 0;
+
+	void* map = e->create();
+	t = now();
+	for (int i = 0; i < n; i++){
+		e->insert(map, shuffled[i], &sorted[i]);
+	}
+	insert = now() - t;
+
+	t = now();
+	for (int i = 0; i < n; i++){
+		sink += e->get(map, lookups[i]) != NULL;
+	}
+	get = now() - t;
+
+	// n / SCAN_LENGTH scans, so about n keys are read in all
+	int n_scans = n / SCAN_LENGTH > 0 ? n / SCAN_LENGTH : 1;
+	t = now();
+	for (int i = 0; i < n_scans; i++){
+		sink += e->scan(map, lookups[i], SCAN_LENGTH);
+	}
+	scan = now() - t;
+
+	// One iterator from the smallest key to the end
+	t = now();
+	sink += e->scan(map, sorted[0], n);
+	full = now() - t;
+
+	t = now();
+	for (int i = 0; i < n; i++){
+		e->remove(map, lookups[i]);
+	}
+	remove = now() - t;
+	e->free(map);
+
+	t = now();
+	map = e->build(sorted, n);
+	build = now() - t;
+
+	// The built map's nodes sit in key order, so this scan misses less
+	t = now();
+	sink += e->scan(map, sorted[0], n);
+	built_scan = now() - t;
+	e->free(map);
+
+	printf("%-6s %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %s\n", e->name,
+		insert * 1e9 / n, get * 1e9 / n, scan * 1e9 / ((double)n_scans * SCAN_LENGTH),
+		full * 1e9 / n, remove * 1e9 / n, build * 1e9 / n, built_scan * 1e9 / n, sink == 0 ? "(no keys found)" : "");
+}
+
+// Function to insert keys[0..n) in order into a new map, then look every
+// key up in random order.  Stores nanoseconds per key of each
+void bench_order(struct engine* e, int* keys, int n, double* insert, double* get){
+	unsigned state = 2463534242u;
+	long long found = 0;
+
+	void* map = e->create();
+	double t = now();
+	for (int i = 0; i < n; i++){
+		e->insert(map, keys[i], &keys[i]);
+	}
+	*insert = (now() - t) * 1e9 / n;
+
+	t = now();
+	for (int i = 0; i < n; i++){
+		found += e->get(map, keys[next_random(&state) % (unsigned)n]) != NULL;
+	}
+	*get = (now() - t) * 1e9 / n;
+	e->free(map);
+
+	if (found != n){
+		printf("%s lost keys\n", e->name);
+	}
+}
+
+// Function to print one map's row of the insert order table
+void bench_engine_orders(struct engine* e, int* sorted, int* reversed, int* shuffled, int n){
+	double insert[3], get[3];
+
+	// A degenerate map gets a shorter prefix of the ordered keys
+	int ordered = e->degenerate && n > DEGENERATE_MAX ? DEGENERATE_MAX : n;
+	bench_order(e, sorted, ordered, &insert[0], &get[0]);
+	bench_order(e, reversed + (n - ordered), ordered, &insert[1], &get[1]);
+	bench_order(e, shuffled, n, &insert[2], &get[2]);
+
+	printf("%-6s %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f%s\n", e->name,
+		insert[0], get[0], insert[1], get[1], insert[2], get[2],
+		ordered < n ? " (ordered: first keys only)" : "");
+}
+
+int main(int argc, char const *argv[]) {
+
+	int n = argc > 1 ? atoi(argv[1]) : 1000000;
+	if (n < 1){
+		fprintf(stderr, "Usage: %s [keys]\n", argv[0]);
+		return 1;
+	}
+
+	// Even keys, so a seek can start between two of them
+	int* sorted = malloc(n * sizeof(int));
+	int* shuffled = malloc(n * sizeof(int));
+	int* lookups = malloc(n * sizeof(int));
+	if (sorted == NULL || shuffled == NULL || lookups == NULL){
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	unsigned state = 2463534242u;
+	for (int i = 0; i < n; i++){
+		sorted[i] = 2 * i;
+		shuffled[i] = 2 * i;
+	}
+	for (int i = n - 1; i > 0; i--){
+		int j = next_random(&state) % (i + 1);
+		int swap = shuffled[i];
+		shuffled[i] = shuffled[j];
+		shuffled[j] = swap;
+	}
+
+	// Lookups and removes visit the keys in a different random order
+	for (int i = 0; i < n; i++){
+		lookups[i] = shuffled[i];
+	}
+	for (int i = n - 1; i > 0; i--){
+		int j = next_random(&state) % (i + 1);
+		int swap = lookups[i];
+		lookups[i] = lookups[j];
+		lookups[j] = swap;
+	}
+
+	struct engine engines[] = {
+		{ "bplus", bench_bplus_create, bench_bplus_build, bench_bplus_insert, bench_bplus_get, bench_bplus_scan, bench_bplus_remove, bench_bplus_free, 0 },
+		{ "bst", bench_bst_create, bench_bst_build, bench_bst_insert, bench_bst_get, bench_bst_scan, bench_bst_remove, bench_bst_free, 1 },
+		{ "bst-rb", bench_bst_balanced_create, bench_bst_build, bench_bst_insert, bench_bst_get, bench_bst_scan, bench_bst_remove, bench_bst_free, 0 },
+		{ "avl", bench_avl_create, bench_avl_build, bench_avl_insert, bench_avl_get, bench_avl_scan, bench_avl_remove, bench_avl_free, 0 },
+	};
+
+	printf("%d keys, nanoseconds per key\n", n);
+	printf("%-6s %10s %10s %10s %10s %10s %10s %10s\n", "map", "insert", "get", "scan", "full scan", "remove", "build", "built scan");
+	for (int i = 0; i < (int)(sizeof(engines) / sizeof(engines[0])); i++){
+		bench_engine(&engines[i], sorted, shuffled, lookups, n);
+	}
+
+	// The lookups are not needed anymore, reuse them for the reversed keys
+	int* reversed = lookups;
+	for (int i = 0; i < n; i++){
+		reversed[i] = sorted[n - 1 - i];
+	}
+
+	printf("\ninsert order, nanoseconds per key\n");
+	printf("%-6s %10s %10s %10s %10s %10s %10s\n", "map", "sorted", "get", "reverse", "get", "random", "get");
+	for (int i = 0; i < (int)(sizeof(engines) / sizeof(engines[0])); i++){
+		bench_engine_orders(&engines[i], sorted, reversed, shuffled, n);
+	}
+
+	free(sorted);
+	free(shuffled);
+	free(lookups);
+
+	return 0;
+}